@@ -0,0 +1,19 @@
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <vector>
+#include "Sphere.h"
+
+#if defined __linux__ || defined __APPLE__
+#else
+#define M_PI 3.141592653589793
+#define INFINITY 1e8
+#endif
+
+#define MAX_RAY_DEPTH 5
+
+//Colors rays by tracing them through a list of spheres, used by the renderer and the benchmarks
+float mix(const float &, const float &, const float &);
+Vec3f trace(const Vec3f &, const Vec3f &, const std::vector<Sphere> &, const int &);
+
+#endif //__TRACE_H__
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "Bench.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+//Ray tracer benchmarks: Sphere::intersect and trace() for single rays (micro) and a whole frame (macro)
+//Usage: bench with the options in Bench.h, e.g. bench --json base.json then bench --baseline base.json
+
+int main(int argc, char **argv){
+
+	Bench bench(argc, argv);
+
+	//The scene drawn by renderSpheres.cpp
+	std::vector<Sphere> spheres;
+	spheres.push_back(Sphere(Vec3f(0.0,-10004, -20), 10000, Vec3f(0.2,0.2,0.2), 0, 0.0));
+	spheres.push_back(Sphere(Vec3f(0.0,0, -20), 			4, Vec3f(1.0,0.32,0.36), 1, 0.5));
+	spheres.push_back(Sphere(Vec3f(5,-1, -15), 				2, Vec3f(0.9,0.76,0.46), 1, 0.0));
+	spheres.push_back(Sphere(Vec3f(5,0, -25), 				3, Vec3f(0.65,0.77,0.97), 1, 0.0));
+	spheres.push_back(Sphere(Vec3f(-5.5,0, -15), 			3, Vec3f(0.9,0.9,0.9), 1, 0.0));
+	spheres.push_back(Sphere(Vec3f(0.0,20, -30),	 		3, Vec3f(0.0,0.0,0.0), 0, 0.0, Vec3f(3)));
+
+	//Camera rays of every pixel of the 640x480 render, generated as in render()
+	const unsigned width = 640, height = 480;
+	float angle = tan(M_PI * 0.5 * 30 / 180), aspectRatio = width / float(height);
+	std::vector<Vec3f> rays;
+	rays.reserve(width*height);
+	for(unsigned y=0; y<height; y++){
+		for(unsigned x=0; x<width; x++){
+			Vec3f rayDirection((2*((x+0.5)/width) - 1) * angle * aspectRatio, (1 - 2*((y+0.5)/height)) * angle, -1);
+			rays.push_back(rayDirection.normalize());
+		}
+	}
+
+	//Intersections with the red glass sphere, rays through the middle of the image hit it and the others mostly miss
+	const Sphere& glass = spheres[1];
+	std::vector<Vec3f> hits, misses;
+	for(const Vec3f& ray : rays){
+		float near, far;
+		(glass.intersect(Vec3f(0), ray, near, far) ? hits : misses).push_back(ray);
+	}
+	size_t nextHit = 0, nextMiss = 0;
+	bench.run("sphere.intersect.hit", [&](){
+		float near, far;
+		bool hit = glass.intersect(Vec3f(0), hits[nextHit], near, far);
+		keep(hit);
+		keep(near);
+		nextHit = (nextHit+1) % hits.size();
+	});
+	bench.run("sphere.intersect.miss", [&](){
+		float near, far;
+		bool hit = glass.intersect(Vec3f(0), misses[nextMiss], near, far);
+		keep(hit);
+		nextMiss = (nextMiss+1) % misses.size();
+	});
+
+	//Camera rays traced with their reflections and refractions, in a random order so every sample sees the whole image
+	std::vector<Vec3f> shuffled = rays;
+	std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(1));
+	size_t nextRay = 0;
+	bench.run("trace.ray", [&](){
+		Vec3f color = trace(Vec3f(0), shuffled[nextRay], spheres, 0);
+		keep(color);
+		nextRay = (nextRay+1) % shuffled.size();
+	});
+
+	//Every pixel of the render, throughput counts the frame's 8 bit RGB bytes as written to the PPM
+	std::vector<Vec3f> image(rays.size());
+	bench.run("trace.frame", [&](){
+		for(size_t i=0; i<rays.size(); i++) image[i] = trace(Vec3f(0), rays[i], spheres, 0);
+		keep(image[0]);
+	}, 3.0 * width * height);
+
+	return bench.finish();
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#ifndef __BOUNDEDQUEUE_H__
+#define __BOUNDEDQUEUE_H__
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+//Thread safe FIFO queue with a fixed capacity
+//Producers block while the queue is full so memory use stays bounded, consumers block while it is empty
+template <typename T>
+class BoundedQueue {
+private:
+	std::deque<T> items_;
+	std::size_t capacity_;
+	bool closed_;
+	std::mutex mutex_;
+	std::condition_variable notEmpty_;
+	std::condition_variable notFull_;
+
+public:
+	BoundedQueue(const std::size_t);
+
+	bool push(T);
+	bool pop(T &);
+	void close();
+};
+
+//Constructor
+template <typename T>
+BoundedQueue<T>::BoundedQueue(const std::size_t capacity) : items_(), capacity_(capacity ? capacity : 1), closed_(false) {}
+
+//Add an item, waits for room if the queue is full
+//Returns false if the queue was closed, the item is dropped in that case
+template <typename T>
+bool BoundedQueue<T>::push(T item){
+	std::unique_lock<std::mutex> lock(mutex_);
+	notFull_.wait(lock, [this]{ return closed_ || items_.size() < capacity_; });
+	if(closed_) return false;
+
+	items_.push_back(std::move(item));
+	lock.unlock();
+	notEmpty_.notify_one();
+	return true;
+}
+
+//Remove the oldest item, waits for one if the queue is empty
+//Returns false once the queue is closed and every item has been taken
+template <typename T>
+bool BoundedQueue<T>::pop(T &item){
+	std::unique_lock<std::mutex> lock(mutex_);
+	notEmpty_.wait(lock, [this]{ return closed_ || !items_.empty(); });
+	if(items_.empty()) return false;
+
+	item = std::move(items_.front());
+	items_.pop_front();
+	lock.unlock();
+	notFull_.notify_one();
+	return true;
+}
+
+//No more items will be pushed, wakes up every waiting thread
+template <typename T>
+void BoundedQueue<T>::close(){
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		closed_ = true;
+	}
+	notEmpty_.notify_all();
+	notFull_.notify_all();
+}
+
+#endif //__BOUNDEDQUEUE_H__
\ No newline at end of file
@@ -1,85 +1,315 @@
-#ifndef	__BRESENHAM_H__
-#define __BRESENHAM_H__
-
-
-#include "TGAImage.h"
-#include "Geometry.h"
-#include "Model.h"
-
-#include <cmath>
-
-void line(int x0, int y0, int x1, int y1, TGAImage &image, const TGAColor& color){
-	bool steep = false;							
-	if(std::abs(x0-x1) < std::abs(y0-y1)){		//Is change in y greater than change in x (is slope > 1?)
-		std::swap(x0, y0);						//Swap x and y coordinates so the change in x is always greater
-		std::swap(x1, y1);
-		steep = true;
-	}
-
-	if(x0>x1){									//Make sure x0 is always less than x1
-		std::swap(x0, x1);
-		std::swap(y0, y1);
-	}
-
-	//See the scale funciton in the TGAImage for explanation on errors variables or variables ending in 2
-	int dx = x1-x0;
-	int dy = y1-y0;
-
-	int derror2 = std::abs(dy)*2;
-	int error2 = 0;
-
-	int y = y0;
-	const int yIncr = y1>y0 ? 1: -1;
-
-	//Duplicate code to prevent rechecking bool each iteration (reduction of branching)
-	if(steep){
-		for(int x=x0; x<=x1; x++){
-			image.set(y, x, color);		//We swapped the coordinates earlier so we need to swap back
-			error2 += derror2;
-			if(error2 > dx) {
-				y+=yIncr;
-				error2 -= dx*2;
-			}	
-		}
-
-
-	}else{
-		for(int x=x0; x<=x1; x++){
-			image.set(x, y, color);
-			error2 += derror2;
-			if(error2 > dx) {
-				y+=yIncr;
-				error2 -= dx*2;
-			}	
-		}
-	}
-
-}
-
-void Bresenham(const Model* model){
-	
-	const int width = 1000;
-	const int height = 1000;
-
-
-	const TGAColor white = TGAColor(255, 255, 255);
-
-	TGAImage image(width, height, TGAImage::RGB);
-	for (int i=0; i<model->nFaces(); i++) { 
-    	std::vector<int> face = model->face(i); 
-    	for (int j=0; j<3; j++) { 
-	        Vec3f v0 = model->vert(face[j]); 
-	        Vec3f v1 = model->vert(face[(j+1)%3]); 
-	        int x0 = (v0.x+1.)*width/2.; 
-	        int y0 = (v0.y+1.)*height/2.; 
-	        int x1 = (v1.x+1.)*width/2.; 
-	        int y1 = (v1.y+1.)*height/2.; 
-	        line(x0, y0, x1, y1, image, white); 
-	    } 
-	}
-
-
-	image.write_tga_file("output.tga");
-}
-
+#ifndef	__BRESENHAM_H__
+#define __BRESENHAM_H__
+
+
+#include "TGAImage.h"
+#include "ImageView.h"
+#include "TiledImage.h"
+#include "Geometry.h"
+#include "Model.h"
+#include "EdgeList.h"
+#include "ModelStream.h"
+#include "Transform.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+//Steps of a line's Bresenham walk that fall inside a rectangle, see clipSteps
+//The walk goes along the major axis u, the minor axis v moves by at most one pixel per step
+struct LineSteps {
+	long long u0, v0;						//First pixel of the walk
+	long long du, dv;						//Length along u and v, du >= dv >= 0
+	int vIncr;								//Direction of v
+	bool steep;								//y is the major axis
+	long long kMin, kMax;					//First and last step inside the rectangle
+};
+
+//Finds the steps of a line inside the rectangle [minX,maxX] x [minY,maxY], false if none of its pixels are inside
+//The range comes from the Bresenham steps themselves, so it holds exactly the pixels of the unclipped line in the rectangle
+//64 bit math, screen coordinates of points far off screen don't fit the products in 32 bits
+inline bool clipSteps(const int x0, const int y0, const int x1, const int y1, const int minX, const int minY, const int maxX,
+						const int maxY, LineSteps& steps){
+
+	if(std::max(x0, x1) < minX || std::min(x0, x1) > maxX || std::max(y0, y1) < minY || std::min(y0, y1) > maxY) return false;
+
+	long long u0 = x0, v0 = y0, u1 = x1, v1 = y1;
+	long long uMin = minX, uMax = maxX, vMin = minY, vMax = maxY;
+	steps.steep = std::llabs(u0-u1) < std::llabs(v0-v1);
+	if(steps.steep){						//Steep line, y is the major axis
+		std::swap(u0, v0);
+		std::swap(u1, v1);
+		std::swap(uMin, vMin);
+		std::swap(uMax, vMax);
+	}
+	if(u0 > u1){
+		std::swap(u0, u1);
+		std::swap(v0, v1);
+	}
+
+	const long long du = u1-u0;
+	const long long dv = std::llabs(v1-v0);
+	const int vIncr = v1>v0 ? 1 : -1;
+
+	//Step k draws (u0+k, v0+vIncr*n) where n = (2*dv*k + du-1) / (2*du) is how often the error overflowed before it
+	//Keep the steps with u inside the rectangle, then the ones with n inside [lo,hi] (v inside the rectangle)
+	long long kMin = std::max(0LL, uMin-u0);
+	long long kMax = std::min(du, uMax-u0);
+	const long long lo = vIncr > 0 ? vMin-v0 : v0-vMax;
+	const long long hi = vIncr > 0 ? vMax-v0 : v0-vMin;
+	if(hi < 0) return false;
+	if(dv == 0){
+		if(lo > 0) return false;
+	}else{
+		if(lo > 0) kMin = std::max(kMin, (2*du*lo - du + 2*dv)/(2*dv));		//First step with n >= lo
+		kMax = std::min(kMax, (2*du*(hi+1) - du)/(2*dv));						//Last step with n <= hi
+	}
+	if(kMin > kMax) return false;
+
+	steps.u0 = u0;
+	steps.v0 = v0;
+	steps.du = du;
+	steps.dv = dv;
+	steps.vIncr = vIncr;
+	steps.kMin = kMin;
+	steps.kMax = kMax;
+	return true;
+}
+
+//Draws the part of a line inside the rectangle [minX,maxX] x [minY,maxY] straight into a view
+//It draws exactly the pixels of the unclipped line that fall inside the rectangle (see clipSteps), and the loop doesn't
+//check bounds. Lines missing the rectangle draw nothing
+template <TGAImage::Format F>
+void lineSpan(const int x0, const int y0, const int x1, const int y1, const ImageView<F>& view,
+				const int minX, const int minY, const int maxX, const int maxY, const Pixel<F>& pixel){
+
+	LineSteps steps;
+	if(!clipSteps(x0, y0, x1, y1, minX, minY, maxX, maxY, steps)) return;
+	const long long u0 = steps.u0, v0 = steps.v0, du = steps.du, dv = steps.dv, kMin = steps.kMin, kMax = steps.kMax;
+	const int vIncr = steps.vIncr;
+	const long long uStride = steps.steep ? view.pitch() : F, vStride = steps.steep ? F : view.pitch();
+
+	//Resume the loop at step kMin with the error it would have had
+	const long long n = du ? (2*dv*kMin + du-1)/(2*du) : 0;
+	long long error2 = 2*dv*kMin - 2*du*n;
+	const long long derror2 = dv*2;
+	const long long vStep = vIncr*vStride;
+	std::uint8_t* p = reinterpret_cast<std::uint8_t*>(view.row(0)) + (u0+kMin)*uStride + (v0+vIncr*n)*vStride;
+
+	for(long long k=kMin; k<=kMax; k++){
+		*reinterpret_cast<Pixel<F>*>(p) = pixel;
+		if(k == kMax) break;					//Don't step the pointer past the last pixel
+		p += uStride;
+		error2 += derror2;
+		if(error2 > du){
+			p += vStep;
+			error2 -= du*2;
+		}
+	}
+}
+
+//Draws the part of a line inside the rectangle [minX,maxX] x [minY,maxY] of the image
+void clippedLine(const int x0, const int y0, const int x1, const int y1, TGAImage &image, const TGAColor& color,
+				int minX, int minY, int maxX, int maxY){
+	if(!image.get_width() || !image.get_height()) return;
+	minX = std::max(minX, 0);
+	minY = std::max(minY, 0);
+	maxX = std::min(maxX, image.get_width()-1);
+	maxY = std::min(maxY, image.get_height()-1);
+
+	switch(image.get_bytespp()){
+		case TGAImage::RGBA: lineSpan(x0, y0, x1, y1, ImageView<TGAImage::RGBA>(image), minX, minY, maxX, maxY, Pixel<TGAImage::RGBA>(color)); break;
+		case TGAImage::RGB: lineSpan(x0, y0, x1, y1, ImageView<TGAImage::RGB>(image), minX, minY, maxX, maxY, Pixel<TGAImage::RGB>(color)); break;
+		case TGAImage::GRAYSCALE: lineSpan(x0, y0, x1, y1, ImageView<TGAImage::GRAYSCALE>(image), minX, minY, maxX, maxY, Pixel<TGAImage::GRAYSCALE>(color)); break;
+	}
+}
+
+//Draws a line with Bresenham's algorithm, the parts outside the image are clipped off
+void line(int x0, int y0, int x1, int y1, TGAImage &image, const TGAColor& color){
+	clippedLine(x0, y0, x1, y1, image, color, 0, 0, image.get_width()-1, image.get_height()-1);
+}
+
+//Draws a line into a tiled image, every tile it crosses draws its own clipped span
+//Lines are the same under integer translation, so each tile draws from coordinates relative to its corner
+template <TGAImage::Format F>
+void tiledLine(const int x0, const int y0, const int x1, const int y1, TiledImage& image, const Pixel<F>& pixel){
+	const int size = image.tileSize();
+	const int minY = std::max(std::min(y0, y1), 0), maxY = std::min(std::max(y0, y1), image.get_height()-1);
+	const int minX = std::max(std::min(x0, x1), 0), maxX = std::min(std::max(x0, x1), image.get_width()-1);
+	if(minX > maxX || minY > maxY) return;
+
+	for(int ty=minY/size; ty<=maxY/size; ty++){
+		//Columns the line can reach in this row of tiles: a Bresenham pixel is within half a pixel of the line along
+		//the minor axis, one more pixel on each side covers rounding
+		int left = minX, right = maxX;
+		if(y0 != y1){
+			const double top = std::max(ty*size, minY)-0.5, bottom = std::min((ty+1)*size-1, maxY)+0.5;
+			const double xTop = x0 + double(x1-x0)*(top-y0)/(y1-y0), xBottom = x0 + double(x1-x0)*(bottom-y0)/(y1-y0);
+			left = std::max(left, int(std::floor(std::min(xTop, xBottom)))-1);
+			right = std::min(right, int(std::ceil(std::max(xTop, xBottom)))+1);
+		}
+		for(int tx=left/size; tx<=right/size; tx++){
+			//Only tiles the line draws in are mapped, a tile that can't be mapped loses its span only
+			const int ox = tx*size, oy = ty*size;
+			LineSteps steps;
+			if(!clipSteps(x0, y0, x1, y1, ox, oy, std::min(ox+size, image.get_width())-1, std::min(oy+size, image.get_height())-1, steps))
+				continue;
+			const ImageView<F> view = image.view<F>(tx, ty);
+			if(view.empty()) continue;
+			lineSpan(x0-ox, y0-oy, x1-ox, y1-oy, view, 0, 0, view.width()-1, view.height()-1, pixel);
+		}
+	}
+}
+
+//Draws a line into a tiled image, the parts outside the image are clipped off and only the tiles it crosses are touched
+void line(int x0, int y0, int x1, int y1, TiledImage &image, const TGAColor& color){
+	switch(image.get_bytespp()){
+		case TGAImage::RGBA: tiledLine(x0, y0, x1, y1, image, Pixel<TGAImage::RGBA>(color)); break;
+		case TGAImage::RGB: tiledLine(x0, y0, x1, y1, image, Pixel<TGAImage::RGB>(color)); break;
+		case TGAImage::GRAYSCALE: tiledLine(x0, y0, x1, y1, image, Pixel<TGAImage::GRAYSCALE>(color)); break;
+	}
+}
+
+#define BAND_ROWS 64			//Rows of the image a thread draws at a time in drawSegments
+
+//Draws line segments stored as x0,y0,x1,y1 screen coordinates, nThreads threads share the work and 0 uses every core
+//Each thread takes bands of BAND_ROWS rows and draws the part of every segment inside its band, so no two threads
+//write the same pixel and the image is exactly the one the serial loop draws
+void drawSegments(const std::vector<int>& segments, TGAImage& image, const TGAColor& color, const int nThreads = 1){
+	const int threads = nThreads > 0 ? nThreads : std::max(1u, std::thread::hardware_concurrency());
+	const int n = segments.size()/4;
+	const int* s = segments.data();
+	if(threads == 1){
+		for(int i=0; i<n; i++, s+=4) line(s[0], s[1], s[2], s[3], image, color);
+		return;
+	}
+
+	const int width = image.get_width();
+	const int height = image.get_height();
+	const int nBands = (height+BAND_ROWS-1)/BAND_ROWS;
+	std::atomic<int> next(0);
+
+	auto worker = [&](){
+		for(int band = next++; band < nBands; band = next++){
+			const int minY = band*BAND_ROWS;
+			const int maxY = std::min(height, minY+BAND_ROWS)-1;
+			const int* s = segments.data();
+			for(int i=0; i<n; i++, s+=4)
+				clippedLine(s[0], s[1], s[2], s[3], image, color, 0, minY, width-1, maxY);
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for(int i=1; i<threads; i++) workers.emplace_back(worker);
+	worker();
+	for(std::thread& t : workers) t.join();
+}
+
+//Draws line segments stored as x0,y0,x1,y1 screen coordinates into a tiled image, on one thread (see TiledImage)
+void drawSegments(const std::vector<int>& segments, TiledImage& image, const TGAColor& color){
+	const int* s = segments.data();
+	for(size_t i=0; i+3<segments.size(); i+=4, s+=4) line(s[0], s[1], s[2], s[3], image, color);
+}
+
+//Screen segments of a model's edges framed by a viewport, every unique edge once (see drawSegments)
+//edgeFilter selects which edges are kept (see EdgeList::Filter), featureAngle is used by EdgeList::FEATURE
+std::vector<int> wireframeSegments(const Model* model, const Viewport& view, const int edgeFilter = EdgeList::ALL, const float featureAngle = 30){
+	//Edges shared by two faces would otherwise be drawn twice
+	EdgeList edgeList(model);
+	std::vector<int> edges = edgeList.select(edgeFilter, featureAngle);
+
+	//Each vertex is transformed once, not once per edge end
+	VertexBuffer screen;
+	transformVertices(model->verts(), view, screen);
+
+	std::vector<int> segments;
+	segments.reserve(edges.size()*4);
+	for(int i : edges){
+		const Edge& e = edgeList.edge(i);
+		segments.insert(segments.end(), {screen.ix[e.v0], screen.iy[e.v0], screen.ix[e.v1], screen.iy[e.v1]});
+	}
+	return segments;
+}
+
+//Draws the wireframe of a model into an image, seen through the model to clip matrix mvp (see Camera::matrix)
+//edgeList must be the model's, it can be kept for every view of the model
+//viewDir is the direction the camera looks in model space, used for EdgeList::SILHOUETTE
+//Edges are clipped against the near plane and a guard band in clip space, so the camera can be inside the model
+void Bresenham(const Model* model, const EdgeList& edgeList, const Mat4f& mvp, const Vec3f& viewDir, TGAImage& image,
+				const int edgeFilter = EdgeList::ALL, const float featureAngle = 30, const int nThreads = 1){
+
+	const TGAColor white = TGAColor(255, 255, 255);
+	const int width = image.get_width(), height = image.get_height();
+
+	std::vector<int> edges = edgeList.select(edgeFilter, featureAngle, viewDir);
+
+	VertexBuffer screen;
+	projectVertices(model->verts(), mvp, width, height, screen);
+
+	//Keeps clipped end points within a few image sizes, where 32 bit line math is exact
+	const float guardX = 8, guardY = 8;
+
+	std::vector<int> segments;
+	segments.reserve(edges.size()*4);
+	for(int i : edges){
+		const Edge& e = edgeList.edge(i);
+		const Vec4f& c0 = screen.clip[e.v0];
+		const Vec4f& c1 = screen.clip[e.v1];
+		if(inGuardBand(c0, guardX, guardY) && inGuardBand(c1, guardX, guardY)){
+			segments.insert(segments.end(), {screen.ix[e.v0], screen.iy[e.v0], screen.ix[e.v1], screen.iy[e.v1]});
+			continue;
+		}
+		Vec4f a = c0, b = c1;
+		if(!clipSegment(a, b, guardX, guardY)) continue;
+		Vec3f p0 = toScreen(a, width, height);
+		Vec3f p1 = toScreen(b, width, height);
+		segments.insert(segments.end(), {int(p0.x), int(p0.y), int(p1.x), int(p1.y)});
+	}
+	drawSegments(segments, image, white, nThreads);
+}
+
+//Draws the wireframe of an OBJ file while it is being read, without loading the faces into a Model
+//A reader thread parses the faces in bounded chunks and hands them over in batches, so parsing overlaps with drawing
+//Edges can't be deduplicated without keeping every face, so each face draws all of its edges like the original loop
+//The model is framed to fill the image unless fit is false, in which case [-1,1] is mapped onto the image
+//The image is saved as output.qoi if qoi is true, output.tga otherwise
+void streamBresenham(const char* filename, const int width = 1000, const int height = 1000, const bool fit = true, const bool qoi = false){
+
+	const TGAColor white = TGAColor(255, 255, 255);
+
+	//First pass: vertex positions only, faces may reference vertices defined after them
+	ModelStream stream(filename);
+	if(!stream.loadVertices()) return;
+
+	Viewport view = fit ? Viewport::fit(stream.bboxMin(), stream.bboxMax(), width, height) : Viewport::unit(width, height);
+	VertexBuffer screen;
+	transformVertices(stream.verts(), view, screen);
+
+	TGAImage image(width, height, TGAImage::RGB);
+
+	//Second pass: at most 4 batches are waiting at any time, which bounds memory use
+	BoundedQueue<FaceBatch> queue(4);
+	std::thread reader(&ModelStream::streamFaces, &stream, std::ref(queue), 4096);
+
+	FaceBatch batch;
+	while(queue.pop(batch)){
+		const int* face = batch.indices.data();
+		for(int n : batch.sizes){
+			for(int j=0; j<n; j++){
+				int v0 = face[j];
+				int v1 = face[(j+1)%n];
+				line(screen.ix[v0], screen.iy[v0], screen.ix[v1], screen.iy[v1], image, white);
+			}
+			face += n;
+		}
+	}
+	reader.join();
+
+	if(qoi) image.write_qoi_file("output.qoi");
+	else image.write_tga_file("output.tga");
+}
+
 #endif //__BRESENHAM_H__
\ No newline at end of file
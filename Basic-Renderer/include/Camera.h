@@ -0,0 +1,26 @@
+#ifndef __CAMERA_H__
+#define __CAMERA_H__
+
+#include "Geometry.h"
+
+//Camera looking from eye at target, gives the view and projection matrices that take model space to clip space
+//Clip space follows OpenGL: visible points have -w <= x,y,z <= w, z/w is -1 on the near plane and grows with distance
+class Camera {
+public:
+	Vec3f eye, target, up;
+	float fov;						//Vertical field of view in degrees, 0 makes an orthographic camera
+	float height;					//Height of the view of an orthographic camera
+	float zNear, zFar;				//Distances to the near and far planes
+
+	Camera();
+	Camera(const Vec3f&, const Vec3f&, const Vec3f& =Vec3f(0,1,0), const float =40);
+
+	Vec3f direction() const;
+	Mat4f view() const;
+	Mat4f projection(const float) const;
+	Mat4f matrix(const int, const int) const;
+
+	static Camera orbit(const Vec3f&, const Vec3f&, const float, const float, const float =40, const float =1);
+};
+
+#endif //__CAMERA_H__
\ No newline at end of file
@@ -0,0 +1,23 @@
+#ifndef __CULL_H__
+#define __CULL_H__
+
+#include "Geometry.h"
+#include "Model.h"
+
+#include <vector>
+
+//Culling tests applied before faces reach the rasterizer, can be combined with |
+enum Cull { CULL_NONE=0, CULL_BACK=1, CULL_FRUSTUM=2, CULL_OCCLUSION=4, CULL_ALL=7 };
+
+//Run of consecutive faces of a model and the bounding box of their vertices
+//Faces that follow each other in a file (or after Model::optimize) are close together, so the boxes are tight
+struct Cluster {
+	int firstFace, nFaces;
+	Vec3f min, max;
+};
+
+std::vector<Cluster> buildClusters(const Model*, const int =64);
+bool inFrustum(const Mat4f&, const Vec3f&, const Vec3f&);
+bool backFacing(const Vec3f*);
+
+#endif //__CULL_H__
\ No newline at end of file
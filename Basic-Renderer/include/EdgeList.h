@@ -0,0 +1,33 @@
+#ifndef __EDGELIST_H__
+#define __EDGELIST_H__
+
+#include "Geometry.h"
+#include "Model.h"
+
+#include <vector>
+
+//Undirected mesh edge shared by up to two faces
+struct Edge {
+	int v0, v1;			//Vertex indices, always stored with v0 < v1
+	int f0, f1;			//Adjacent faces, f1 is -1 on a boundary edge
+	int nFaces;			//Number of faces using the edge (more than 2 means the edge is non-manifold)
+};
+
+//Deduplicated edge list of a model, each edge is stored once no matter how many faces share it
+class EdgeList {
+private:
+	std::vector<Edge> edges_;
+	std::vector<Vec3f> faceNormals_;
+
+public:
+	//Filters used by select(), can be combined with |
+	enum Filter { ALL=0, FEATURE=1, SILHOUETTE=2 };
+
+	EdgeList(const Model*);
+	int nEdges() const;
+	const Edge& edge(int) const;
+	Vec3f faceNormal(int) const;
+	std::vector<int> select(const int, const float =30, const Vec3f& =Vec3f(0,0,-1)) const;
+};
+
+#endif //__EDGELIST_H__
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef __FRAMEWRITER_H__
+#define __FRAMEWRITER_H__
+
+#include "TGAImage.h"
+#include "BoundedQueue.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+//Writes a sequence of frames on a background thread so encoding and disk writes overlap with rendering the next frame
+//Frames are drawn into a ring of reusable images: acquire() hands out a cleared free one, waiting while every image is
+//still queued for writing, submit() queues it and the writer thread gives it back once the file is written
+class FrameWriter {
+private:
+	struct Job {
+		int frame;							//Image of the ring
+		std::string filename;
+	};
+
+	std::vector<TGAImage> frames_;
+	BoundedQueue<int> free_;
+	BoundedQueue<Job> pending_;
+	std::thread writer_;
+	int failures_;							//Files that couldn't be written, only touched by the writer thread until finish()
+	bool finished_;
+
+	void run();
+
+public:
+	FrameWriter(const int, const int, const int =TGAImage::RGB, const int =3);
+	~FrameWriter();
+
+	int acquire();
+	TGAImage& frame(const int);
+	void submit(const int, const std::string&);
+	int finish();
+};
+
+#endif //__FRAMEWRITER_H__
\ No newline at end of file
@@ -1,12 +1,16 @@
-#ifndef __GEOMETRY_H__
-#define __GEOMETRY_H__
-
-#include "Vec2.h"
-#include "Vec3.h"
-
-typedef Vec2<int> Vec2i;
-typedef Vec2<float> Vec2f;
-typedef Vec3<int> Vec3i;
-typedef Vec3<float> Vec3f;
-
+#ifndef __GEOMETRY_H__
+#define __GEOMETRY_H__
+
+#include "Vec2.h"
+#include "Vec3.h"
+#include "Vec4.h"
+#include "Matrix.h"
+
+typedef Vec2<int> Vec2i;
+typedef Vec2<float> Vec2f;
+typedef Vec3<int> Vec3i;
+typedef Vec3<float> Vec3f;
+typedef Vec4<float> Vec4f;
+typedef Mat4<float> Mat4f;
+
 #endif //__GEOMETRY_H__
\ No newline at end of file
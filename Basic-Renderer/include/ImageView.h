@@ -0,0 +1,175 @@
+#ifndef __IMAGEVIEW_H__
+#define __IMAGEVIEW_H__
+
+#include "TGAImage.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+//One pixel of a format, F bytes in TGA order (BGR(A), or a single gray byte) with no padding, so an array of them is a
+//row of an image. Copies are fixed size moves the compiler can combine and vectorize
+template<TGAImage::Format F>
+struct Pixel {
+	std::uint8_t bgra[F];
+
+	Pixel() = default;
+	Pixel(const TGAColor&);
+};
+
+//Pixels [first,last) of a row, for range based loops
+template<TGAImage::Format F>
+struct Span {
+	Pixel<F>* first;
+	Pixel<F>* last;
+
+	Pixel<F>* begin() const { return first; }
+	Pixel<F>* end() const { return last; }
+	int size() const { return last-first; }
+	Pixel<F>& operator[](const int i) const { return first[i]; }
+};
+
+//Typed window on pixels of one format: rows are F byte pixels pitch bytes apart, nothing is checked per pixel
+//Rows are in the buffer's order, for a TGAImage that is its data order (see TGAImage::get_origin), not necessarily top down
+//Views don't own their pixels and stay valid while the image isn't resized or reloaded
+template<TGAImage::Format F>
+class ImageView {
+private:
+	std::uint8_t* data_;
+	int width_, height_;
+	int pitch_;								//Bytes between two rows
+
+public:
+	ImageView();
+	ImageView(std::uint8_t*, const int, const int, const int);
+	ImageView(TGAImage&);
+
+	bool empty() const;
+	int width() const;
+	int height() const;
+	int pitch() const;
+	Pixel<F>* row(const int) const;
+	Pixel<F>& operator()(const int, const int) const;
+	Span<F> span(const int) const;
+	ImageView sub(int, int, int, int) const;
+
+	void fill(const Pixel<F>&) const;
+	void clear() const;
+	void blit(const ImageView&, const int, const int) const;
+};
+
+//Pixel of a color, the color's first F channels
+template<TGAImage::Format F>
+Pixel<F>::Pixel(const TGAColor& c){
+	std::memcpy(bgra, c.bgra, F);
+}
+
+//Empty view
+template<TGAImage::Format F>
+ImageView<F>::ImageView() : data_(nullptr), width_(0), height_(0), pitch_(0) {}
+
+//View of a width x height buffer whose rows are pitch bytes apart
+template<TGAImage::Format F>
+ImageView<F>::ImageView(std::uint8_t* data, const int width, const int height, const int pitch) :
+				data_(data), width_(width), height_(height), pitch_(pitch) {}
+
+//View of a whole image, empty if its pixels aren't of format F
+//A mapped image gets its own copy of the pixels first (see TGAImage::buffer)
+template<TGAImage::Format F>
+ImageView<F>::ImageView(TGAImage& image) : data_(nullptr), width_(0), height_(0), pitch_(0) {
+	if(image.get_bytespp() != F){
+		std::cerr << "Can't view a " << image.get_bytespp() << " bytes per pixel image as " << int(F) << " bytes per pixel\n";
+		return;
+	}
+	if(!image.get_width() || !image.get_height()) return;
+	data_ = image.buffer();
+	width_ = image.get_width();
+	height_ = image.get_height();
+	pitch_ = width_*F;
+}
+
+//Whether the view has no pixels
+template<TGAImage::Format F>
+bool ImageView<F>::empty() const{
+	return !data_ || width_ <= 0 || height_ <= 0;
+}
+
+//Get the view width
+template<TGAImage::Format F>
+int ImageView<F>::width() const{
+	return width_;
+}
+
+//Get the view height
+template<TGAImage::Format F>
+int ImageView<F>::height() const{
+	return height_;
+}
+
+//Get the bytes between two rows
+template<TGAImage::Format F>
+int ImageView<F>::pitch() const{
+	return pitch_;
+}
+
+//First pixel of row y, unchecked
+template<TGAImage::Format F>
+Pixel<F>* ImageView<F>::row(const int y) const{
+	return reinterpret_cast<Pixel<F>*>(data_ + std::ptrdiff_t(y)*pitch_);
+}
+
+//Pixel x,y, unchecked
+template<TGAImage::Format F>
+Pixel<F>& ImageView<F>::operator()(const int x, const int y) const{
+	return row(y)[x];
+}
+
+//Pixels of row y, unchecked
+template<TGAImage::Format F>
+Span<F> ImageView<F>::span(const int y) const{
+	Pixel<F>* first = row(y);
+	return Span<F>{first, first+width_};
+}
+
+//View of the w x h rectangle at x,y, clipped to this view
+template<TGAImage::Format F>
+ImageView<F> ImageView<F>::sub(int x, int y, int w, int h) const{
+	if(x < 0){ w += x; x = 0; }
+	if(y < 0){ h += y; y = 0; }
+	w = std::min(w, width_-x);
+	h = std::min(h, height_-y);
+	if(w <= 0 || h <= 0) return ImageView();
+	return ImageView(data_ + std::ptrdiff_t(y)*pitch_ + std::ptrdiff_t(x)*F, w, h, pitch_);
+}
+
+//Set every pixel to p: the first row is filled, the others are copies of it
+template<TGAImage::Format F>
+void ImageView<F>::fill(const Pixel<F>& p) const{
+	if(empty()) return;
+	Span<F> first = span(0);
+	std::fill(first.begin(), first.end(), p);
+	for(int y=1; y<height_; y++) std::memcpy(row(y), first.first, size_t(width_)*F);
+}
+
+//Set every byte to 0
+template<TGAImage::Format F>
+void ImageView<F>::clear() const{
+	if(empty()) return;
+	if(pitch_ == width_*F){
+		std::memset(data_, 0, size_t(pitch_)*height_);
+		return;
+	}
+	for(int y=0; y<height_; y++) std::memset(row(y), 0, size_t(width_)*F);
+}
+
+//Copy src with its first pixel at x,y, the part outside this view is clipped off
+template<TGAImage::Format F>
+void ImageView<F>::blit(const ImageView& src, const int x, const int y) const{
+	const ImageView dst = sub(x, y, src.width_, src.height_);
+	if(dst.empty() || src.empty()) return;
+	const int sx = std::max(0, -x), sy = std::max(0, -y);
+	for(int j=0; j<dst.height_; j++) std::memmove(dst.row(j), src.row(sy+j)+sx, size_t(dst.width_)*F);
+}
+
+#endif //__IMAGEVIEW_H__
\ No newline at end of file
@@ -0,0 +1,118 @@
+#ifndef __MATRIX_H__
+#define __MATRIX_H__
+
+#include "Vec3.h"
+#include "Vec4.h"
+
+#include <ostream>
+
+template <typename T>
+class Mat4;
+
+template <typename T>
+std::ostream& operator<<(std::ostream&, const Mat4<T> &);
+
+
+//4x4 matrix stored row by row, vectors are columns: v' = M*v
+template <typename T>
+class Mat4 {
+
+public:
+	T m[4][4];
+
+	Mat4();
+
+	static Mat4<T> identity();
+	static Mat4<T> translation(const Vec3<T>&);
+	static Mat4<T> scale(const Vec3<T>&);
+
+	Mat4<T> operator* (const Mat4<T> &) const;
+	Vec4<T> operator* (const Vec4<T> &) const;
+	Vec3<T> transformPoint(const Vec3<T> &) const;
+	Mat4<T> transpose() const;
+
+	friend std::ostream& operator<< <>(std::ostream&, const Mat4<T> &);
+
+};
+
+//Default constructor, all zeros
+template <typename T>
+Mat4<T>::Mat4(){
+	for(int i=0; i<4; i++)
+		for(int j=0; j<4; j++)
+			m[i][j] = T(0);
+}
+
+//Identity matrix
+template <typename T>
+Mat4<T> Mat4<T>::identity(){
+	Mat4<T> r;
+	for(int i=0; i<4; i++) r.m[i][i] = T(1);
+	return r;
+}
+
+//Translation by t
+template <typename T>
+Mat4<T> Mat4<T>::translation(const Vec3<T>& t){
+	Mat4<T> r = identity();
+	r.m[0][3] = t.x;
+	r.m[1][3] = t.y;
+	r.m[2][3] = t.z;
+	return r;
+}
+
+//Scale each axis by s
+template <typename T>
+Mat4<T> Mat4<T>::scale(const Vec3<T>& s){
+	Mat4<T> r = identity();
+	r.m[0][0] = s.x;
+	r.m[1][1] = s.y;
+	r.m[2][2] = s.z;
+	return r;
+}
+
+//Matrix product, (A*B)*v applies B first
+template <typename T>
+Mat4<T> Mat4<T>::operator* (const Mat4<T> &b) const{
+	Mat4<T> r;
+	for(int i=0; i<4; i++)
+		for(int j=0; j<4; j++)
+			r.m[i][j] = m[i][0]*b.m[0][j] + m[i][1]*b.m[1][j] + m[i][2]*b.m[2][j] + m[i][3]*b.m[3][j];
+	return r;
+}
+
+//Transform a homogeneous vector
+template <typename T>
+Vec4<T> Mat4<T>::operator* (const Vec4<T> &v) const{
+	return Vec4<T>(m[0][0]*v.x + m[0][1]*v.y + m[0][2]*v.z + m[0][3]*v.w,
+				   m[1][0]*v.x + m[1][1]*v.y + m[1][2]*v.z + m[1][3]*v.w,
+				   m[2][0]*v.x + m[2][1]*v.y + m[2][2]*v.z + m[2][3]*v.w,
+				   m[3][0]*v.x + m[3][1]*v.y + m[3][2]*v.z + m[3][3]*v.w);
+}
+
+//Transform a point (w=1) and divide by the resulting w
+template <typename T>
+Vec3<T> Mat4<T>::transformPoint(const Vec3<T> &p) const{
+	Vec4<T> r = (*this)*Vec4<T>(p, T(1));
+	return r.xyz()*(T(1)/r.w);
+}
+
+//Transposed matrix
+template <typename T>
+Mat4<T> Mat4<T>::transpose() const{
+	Mat4<T> r;
+	for(int i=0; i<4; i++)
+		for(int j=0; j<4; j++)
+			r.m[i][j] = m[j][i];
+	return r;
+}
+
+template<typename T>
+std::ostream& operator<<(std::ostream& os, const Mat4<T> &a){
+	for(int i=0; i<4; i++)
+		os << "[" << a.m[i][0] << "," << a.m[i][1] << "," << a.m[i][2] << "," << a.m[i][3] << "]\n";
+	return os;
+}
+
+
+#endif //__MATRIX_H__
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef __MODELSTREAM_H__
+#define __MODELSTREAM_H__
+
+#include "Geometry.h"
+#include "BoundedQueue.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+//Group of faces handed from the OBJ reader to the renderer
+struct FaceBatch {
+	std::vector<int> indices;			//Vertex indices of every face in the batch, back to back
+	std::vector<int> sizes;				//Number of vertices of each face
+};
+
+//Reads an OBJ file in fixed size chunks without holding the whole mesh in memory
+//Vertex positions are read in a first pass so faces can reference vertices defined after them,
+//faces are then streamed in batches in a second pass while the consumer draws them
+class ModelStream {
+private:
+	std::string filename_;
+	std::size_t chunkSize_;
+	std::vector<Vec3f> vertices_;
+	std::streamoff faceStart_;			//Offset of the first face line, the second pass starts reading there
+	int faceStartVerts_;				//Number of vertices defined before the first face
+	Vec3f bboxMin_, bboxMax_;			//Bounding box of the vertices, known after the first pass
+
+public:
+	ModelStream(const char*, const std::size_t = 1 << 20);
+	bool loadVertices();
+	bool streamFaces(BoundedQueue<FaceBatch>&, const int = 4096) const;
+	int nVerts() const;
+	Vec3f vert(int) const;
+	const std::vector<Vec3f>& verts() const;
+	Vec3f bboxMin() const;
+	Vec3f bboxMax() const;
+};
+
+#endif //__MODELSTREAM_H__
\ No newline at end of file
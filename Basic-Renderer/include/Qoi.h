@@ -0,0 +1,39 @@
+#ifndef __QOI_H__
+#define __QOI_H__
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+//QOI ("Quite OK Image", https://qoiformat.org) lossless images: every pixel is coded against the previous one as a
+//run, a recently seen color, a small difference or the literal color. Much smaller than TGA RLE for shaded renders
+//and cheap both ways. Rows go from the top, pixels are RGB or RGBA (grayscale is stored as RGB)
+
+//Writes a QOI file a row at a time, so frames can be saved as they are produced without holding the whole image
+//Only the coder state and a buffer of encoded bytes are kept between rows
+class QoiEncoder {
+private:
+	std::ofstream out_;
+	std::vector<std::uint8_t> buffer_;		//Encoded bytes not written yet
+	size_t used_;
+	std::uint32_t index_[64];				//Colors seen last by hash, packed r | g<<8 | b<<16 | a<<24
+	std::uint32_t previous_;
+	int run_;								//Repeats of previous_ not coded yet
+	int width_, height_;
+	int rows_;								//Rows written so far
+
+	bool flush();
+
+public:
+	QoiEncoder();
+	~QoiEncoder();
+
+	bool open(const std::string&, const int, const int, const int);
+	bool writeRow(const std::uint8_t*, const int, const bool =false);
+	bool close();
+};
+
+bool qoiDecode(const std::uint8_t*, const size_t, int&, int&, int&, std::vector<std::uint8_t>&);
+
+#endif //__QOI_H__
\ No newline at end of file
@@ -0,0 +1,139 @@
+#ifndef __RASTERIZE_H__
+#define __RASTERIZE_H__
+
+
+#include "TGAImage.h"
+#include "Geometry.h"
+#include "Model.h"
+#include "Transform.h"
+#include "TileRasterizer.h"
+#include "Cull.h"
+#include "Shader.h"
+#include "my_gl.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+//Draws a model into an image with filled faces and a z-buffer, colored by a shader (see Shader.h)
+//The shader is a template parameter so its vertex and fragment stages are inlined into the pipeline
+//Polygons are split into a fan of triangles, mvp takes model space to clip space (see Camera::matrix)
+//Faces crossing the near plane or reaching past the rasterizer's guard band are clipped in clip space, with their varyings
+//Triangles are binned into screen tiles and drawn by nThreads threads, 0 uses every core
+//cull picks the culling tests (see Cull), back face culling is only right for closed meshes with consistent windings
+//Pixels no face covers keep the image's color
+template<class S, int N>
+void Rasterize(const Model* model, const Shader<S, N>& base, const Mat4f& mvp, TGAImage& image, const int nThreads = 0,
+				const int cull = CULL_FRUSTUM | CULL_OCCLUSION){
+
+	const S& shader = base.derived();
+	const int width = image.get_width(), height = image.get_height();
+	TileRasterizer rasterizer(width, height, nThreads, cull & CULL_OCCLUSION);
+
+	if((cull & CULL_FRUSTUM) && !inFrustum(mvp, model->bboxMin(), model->bboxMax())) return;
+
+	VertexBuffer screen;
+	projectVertices(model->verts(), mvp, width, height, screen);
+
+	//Guard band in units of w, a quarter of the rasterizer's reach on each side of the image center
+	const float guardX = 0.5f*GUARD_BAND/width, guardY = 0.5f*GUARD_BAND/height;
+
+	//Clusters out of view are dropped whole, the rest are drawn nearest first so occlusion culling has occluders early
+	//The screen boxes come from the projected vertices, so they hold exactly the depths the rasterizer will see
+	std::vector<Cluster> clusters = buildClusters(model);
+	std::vector<std::pair<Vec3f, Vec3f>> bounds(clusters.size());
+	std::vector<int> order;
+	order.reserve(clusters.size());
+	for(int c=0; c<int(clusters.size()); c++){
+		if((cull & CULL_FRUSTUM) && !inFrustum(mvp, clusters[c].min, clusters[c].max)) continue;
+		order.push_back(c);
+
+		Vec3f& min = bounds[c].first;
+		Vec3f& max = bounds[c].second;
+		min = Vec3f(FLT_MAX);
+		max = Vec3f(-FLT_MAX);
+		for(int i=clusters[c].firstFace; i<clusters[c].firstFace+clusters[c].nFaces && min.z > -FLT_MAX; i++){
+			for(int v : model->face(i)){
+				if(!inGuardBand(screen.clip[v], guardX, guardY)){
+					//Clipping makes new vertices, they can be anywhere on screen and as close as the near plane
+					min = Vec3f(0, 0, -FLT_MAX);
+					max = Vec3f(width, height, FLT_MAX);
+					break;
+				}
+				min = Vec3f(std::min(min.x, screen.x[v]), std::min(min.y, screen.y[v]), std::min(min.z, screen.z[v]));
+				max = Vec3f(std::max(max.x, screen.x[v]), std::max(max.y, screen.y[v]), std::max(max.z, screen.z[v]));
+			}
+		}
+	}
+	if(cull & CULL_OCCLUSION)
+		std::stable_sort(order.begin(), order.end(), [&](int a, int b){ return bounds[a].first.z < bounds[b].first.z; });
+
+	//Polygon vertices are the clip position followed by the varyings, triangle vertices are 1/w and varyings/w
+	const int stride = 4+N;
+	std::vector<float> polygon, clipped, attributes;
+	std::vector<Vec3f> projected;
+	float varyings[3*(1+N)];
+	for(int c : order){
+		rasterizer.beginCluster(bounds[c].first, bounds[c].second);
+
+		for(int i=clusters[c].firstFace; i<clusters[c].firstFace+clusters[c].nFaces; i++){
+			std::vector<int> face = model->face(i);
+			const int n = face.size();
+			if(n < 3) continue;
+
+			TGAColor color;
+			if(!shader.face(i, color)) continue;
+
+			//Screen positions of the polygon, clipped first if part of it is behind the near plane or too far out
+			bool inside = true;
+			for(int v : face) inside = inside && inGuardBand(screen.clip[v], guardX, guardY);
+			projected.clear();
+			attributes.clear();
+			if(inside && S::flat){
+				for(int v : face) projected.push_back(Vec3f(screen.x[v], screen.y[v], screen.z[v]));
+			}else{
+				polygon.clear();
+				for(int j=0; j<n; j++){
+					const Vec4f& p = screen.clip[face[j]];
+					polygon.insert(polygon.end(), {p.x, p.y, p.z, p.w});
+					polygon.resize(polygon.size()+N);
+					shader.vertex(i, j, &polygon[polygon.size()-N]);
+				}
+				if(inside){
+					for(int v : face) projected.push_back(Vec3f(screen.x[v], screen.y[v], screen.z[v]));
+				}else{
+					clipPolygon(polygon, clipped, stride, guardX, guardY);
+					polygon.swap(clipped);
+					for(int j=0; j<int(polygon.size()); j+=stride)
+						projected.push_back(toScreen(Vec4f(polygon[j], polygon[j+1], polygon[j+2], polygon[j+3]), width, height));
+				}
+				for(int j=0; j<int(polygon.size()); j+=stride){
+					const float w = 1/polygon[j+3];
+					attributes.push_back(w);
+					for(int k=0; k<N; k++) attributes.push_back(polygon[j+4+k]*w);
+				}
+			}
+			if(projected.size() < 3) continue;
+
+			Vec3f pts[3];
+			pts[0] = projected[0];
+			for(int j=1; j+1<int(projected.size()); j++){
+				pts[1] = projected[j];
+				pts[2] = projected[j+1];
+				if((cull & CULL_BACK) && backFacing(pts)) continue;
+				if(S::flat){
+					rasterizer.add(pts, color);
+				}else{
+					std::copy(attributes.data(), attributes.data()+1+N, varyings);
+					std::copy(attributes.data()+j*(1+N), attributes.data()+(j+2)*(1+N), varyings+1+N);
+					rasterizer.add(pts, varyings, 1+N);
+				}
+			}
+		}
+	}
+	rasterizer.draw(image, shader);
+}
+
+#endif //__RASTERIZE_H__
\ No newline at end of file
@@ -0,0 +1,10 @@
+#ifndef __RESAMPLE_H__
+#define __RESAMPLE_H__
+
+#include "TGAImage.h"
+
+#include <cstdint>
+
+void resample(const std::uint8_t*, const int, const int, const int, std::uint8_t*, const int, const int, const TGAImage::Filter, const int =0);
+
+#endif //__RESAMPLE_H__
\ No newline at end of file
@@ -0,0 +1,231 @@
+#ifndef __SHADER_H__
+#define __SHADER_H__
+
+#include "Geometry.h"
+#include "TGAImage.h"
+#include "Model.h"
+#include "Texture.h"
+#include "ShadowMap.h"
+#include "my_gl.h"
+
+#include <algorithm>
+#include <cmath>
+
+//Shader interface of the rasterizer, bound at compile time (CRTP): the pipeline is a template over the shader, so
+//there are no virtual calls and the varying count is a constant the compiler can unroll loops over
+//A shader derives from Shader<itself, number of varyings> and implements
+//	void vertex(const int face, const int corner, float* varying) const		Fill the varyings of a face corner
+//	TGAColor fragment(const float* varying) const							Color of a pixel from its interpolated varyings
+//Varyings are interpolated perspective correctly. Position transform and clipping stay in the pipeline
+//A flat shader sets flat and implements face() instead, its faces are drawn in one color without interpolation
+//Any shader can skip faces by returning false from face(), which is called once per face before its corners
+//A shader can shade a whole block row of fragments at once by implementing fragments(), which gets the screen
+//derivatives of the varyings if it sets derivatives (texture level of detail needs them)
+template<class Derived, int N>
+struct Shader {
+	static const int nVaryings = N;
+	static const bool flat = false;
+	static const bool derivatives = false;
+
+	const Derived& derived() const { return static_cast<const Derived&>(*this); }
+
+	//Color of a whole face for flat shaders, false skips the face (every face is drawn by default)
+	bool face(const int, TGAColor&) const { return true; }
+	void vertex(const int, const int, float*) const {}
+	TGAColor fragment(const float*) const { return TGAColor(); }
+
+	//Colors of the fragments of a block row, varyings holds N floats per fragment and bit i of mask marks fragment i
+	//ddx and ddy are the varyings' derivatives along x and y, null unless the shader sets derivatives
+	void fragments(const float* varyings, const float*, const float*, const int mask, TGAColor* colors) const {
+		for(int i=0; i<BLOCK; i++)
+			if(mask & (1 << i)) colors[i] = derived().fragment(varyings+i*N);
+	}
+};
+
+//Light intensity of a surface with normal n (any length), lit from both sides since OBJ windings aren't reliable
+inline float lambert(const Vec3f& n, const Vec3f& light){
+	float length = std::sqrt(n.length2());
+	return length > 0 ? std::fabs(n.dot(light))/length : 0;
+}
+
+//Gray shade of an intensity in [0,1]
+inline TGAColor gray(const float intensity){
+	float c = std::min(std::max(intensity, 0.f), 1.f)*255;
+	return TGAColor(c, c, c);
+}
+
+//One intensity per face from its geometric (Newell) normal, light points from the model towards the light
+struct FlatShader : public Shader<FlatShader, 0> {
+	static const bool flat = true;
+	const Model* model;
+	Vec3f light;
+
+	FlatShader(const Model* m, const Vec3f& l) : model(m), light(l) {}
+
+	bool face(const int i, TGAColor& color) const {
+		std::vector<int> f = model->face(i);
+		const int n = f.size();
+		Vec3f normal;
+		for(int j=0; j<n; j++){
+			Vec3f a = model->vert(f[j]);
+			Vec3f b = model->vert(f[(j+1)%n]);
+			normal += Vec3f((a.y-b.y)*(a.z+b.z), (a.z-b.z)*(a.x+b.x), (a.x-b.x)*(a.y+b.y));
+		}
+		if(normal.length2() == 0) return false;
+		float intensity = lambert(normal, light);
+		color = TGAColor(intensity*255, intensity*255, intensity*255);
+		return true;
+	}
+};
+
+//Diffuse light computed at the vertices from their normals and interpolated across the face
+struct GouraudShader : public Shader<GouraudShader, 1> {
+	const Model* model;
+	Vec3f light;
+
+	GouraudShader(const Model* m, const Vec3f& l) : model(m), light(l) {}
+
+	void vertex(const int face, const int corner, float* varying) const {
+		varying[0] = lambert(model->normal(model->faceNormal(face, corner)), light);
+	}
+
+	TGAColor fragment(const float* varying) const {
+		return gray(varying[0]);
+	}
+};
+
+//Normals interpolated across the face and lit per pixel, diffuse plus a Blinn-Phong highlight
+//view points from the model towards the viewer
+struct PhongShader : public Shader<PhongShader, 3> {
+	const Model* model;
+	Vec3f light, half;
+	float shininess;
+
+	PhongShader(const Model* m, const Vec3f& l, const Vec3f& view, const float s = 32) : model(m), light(l), half(l+view), shininess(s) {
+		half.normalize();
+	}
+
+	void vertex(const int face, const int corner, float* varying) const {
+		Vec3f n = model->normal(model->faceNormal(face, corner));
+		varying[0] = n.x;
+		varying[1] = n.y;
+		varying[2] = n.z;
+	}
+
+	TGAColor fragment(const float* varying) const {
+		Vec3f n(varying[0], varying[1], varying[2]);
+		float length = std::sqrt(n.length2());
+		if(length == 0) return TGAColor(0, 0, 0);
+		float diffuse = std::fabs(n.dot(light))/length;
+		float specular = std::pow(std::fabs(n.dot(half))/length, shininess);
+		return gray(0.8f*diffuse + 0.4f*specular);
+	}
+};
+
+//Texture sampled trilinearly with the face corners' texture coordinates, modulated by Gouraud light
+//A block row of fragments is sampled together with a level of detail from its derivatives
+//Corners without texture coordinates use (0,0)
+struct TextureShader : public Shader<TextureShader, 3> {
+	static const bool derivatives = true;
+	const Model* model;
+	const Texture* texture;
+	Vec3f light;
+
+	TextureShader(const Model* m, const Texture* t, const Vec3f& l) : model(m), texture(t), light(l) {}
+
+	void vertex(const int face, const int corner, float* varying) const {
+		int t = model->faceUV(face, corner);
+		Vec2f uv = t >= 0 ? model->uv(t) : Vec2f(0, 0);
+		varying[0] = uv.x_;
+		varying[1] = 1-uv.y_;								//OBJ's v goes up from the bottom, Texture's down from the top
+		varying[2] = lambert(model->normal(model->faceNormal(face, corner)), light);
+	}
+
+	TGAColor fragment(const float* varying) const {
+		return texture->sample(varying[0], varying[1])*varying[2];
+	}
+
+	void fragments(const float* varyings, const float* ddx, const float* ddy, const int mask, TGAColor* colors) const {
+		float u[BLOCK], v[BLOCK];
+		std::uint32_t texels[BLOCK];
+		int first = 0;
+		while(!(mask & (1 << first))) first++;
+		for(int i=0; i<BLOCK; i++){
+			//Uncovered fragments borrow a covered one's coordinates, their varyings aren't set
+			const int j = (mask & (1 << i)) ? i : first;
+			u[i] = varyings[j*nVaryings];
+			v[i] = varyings[j*nVaryings+1];
+		}
+		texture->sample4(u, v, texture->lod(ddx[0], ddx[1], ddy[0], ddy[1]), texels);
+		for(int i=0; i<BLOCK; i++){
+			if(!(mask & (1 << i))) continue;
+			const int light = std::min(std::max(int(varyings[i*nVaryings+2]*256), 0), 256);
+			const std::uint8_t* t = reinterpret_cast<const std::uint8_t*>(&texels[i]);
+			colors[i] = TGAColor((t[2]*light) >> 8, (t[1]*light) >> 8, (t[0]*light) >> 8, t[3]);
+		}
+	}
+};
+
+//Any other shader with shadows from a ShadowMap: lit fragments keep the base shader's color, fragments in shadow fall to
+//the ambient level. The fragment's position in the map is 3 more varyings, it is affine in model space so interpolating
+//it is exact. A flat base shader's face color becomes 3 constant varyings. pcf is the filter radius in texels (see lit)
+template<class Base>
+struct Shadowed : public Shader<Shadowed<Base>, (Base::flat ? 3 : Base::nVaryings)+3> {
+	static const int nBase = Base::flat ? 3 : Base::nVaryings;	//Varyings of the base shader, before the map position
+	static const int nVaryings = nBase+3;
+	static const bool derivatives = Base::derivatives;
+	Base base;
+	const Model* model;
+	const ShadowMap* shadow;
+	int pcf;
+	float ambient;
+
+	Shadowed(const Base& b, const Model* m, const ShadowMap* s, const int p = 1, const float a = 0.3f) :
+				base(b), model(m), shadow(s), pcf(p), ambient(a) {}
+
+	//Faces the base shader skips are skipped
+	bool face(const int i, TGAColor& color) const {
+		return base.face(i, color);
+	}
+
+	void vertex(const int face, const int corner, float* varying) const {
+		if(Base::flat){
+			TGAColor color(0, 0, 0);
+			base.face(face, color);
+			for(int k=0; k<3; k++) varying[k] = color.bgra[k];
+		}else{
+			base.vertex(face, corner, varying);
+		}
+		Vec3f p = shadow->project(model->vert(model->faceVert(face, corner)));
+		varying[nBase] = p.x;
+		varying[nBase+1] = p.y;
+		varying[nBase+2] = p.z;
+	}
+
+	float light(const float* varying) const {
+		return ambient + (1-ambient)*shadow->lit(varying[nBase], varying[nBase+1], varying[nBase+2], pcf);
+	}
+
+	TGAColor fragment(const float* varying) const {
+		if(Base::flat) return TGAColor(std::lrint(varying[2]), std::lrint(varying[1]), std::lrint(varying[0]))*light(varying);
+		return base.fragment(varying)*light(varying);
+	}
+
+	void fragments(const float* varyings, const float* ddx, const float* ddy, const int mask, TGAColor* colors) const {
+		if(Base::flat){
+			for(int i=0; i<BLOCK; i++)
+				if(mask & (1 << i)) colors[i] = fragment(varyings+i*nVaryings);
+			return;
+		}
+		//The base shader reads its own varyings back to back, its derivatives come first already
+		float inner[BLOCK*(nBase > 0 ? nBase : 1)];
+		for(int i=0; i<BLOCK; i++)
+			if(mask & (1 << i))
+				for(int k=0; k<nBase; k++) inner[i*nBase+k] = varyings[i*nVaryings+k];
+		base.fragments(inner, ddx, ddy, mask, colors);
+		for(int i=0; i<BLOCK; i++)
+			if(mask & (1 << i)) colors[i] = colors[i]*light(varyings+i*nVaryings);
+	}
+};
+
+#endif //__SHADER_H__
\ No newline at end of file
@@ -0,0 +1,31 @@
+#ifndef __SHADOWMAP_H__
+#define __SHADOWMAP_H__
+
+#include "Geometry.h"
+#include "Model.h"
+
+#include <vector>
+
+#define SHADOW_MAX_SIZE 8192			//Largest map size, a larger map reaches past the rasterizer's GUARD_BAND and drops every face
+#define SHADOW_MAX_PCF 8				//Largest filter radius, (2*8+1)^2 = 289 depth lookups per pixel
+
+//Depth of a model seen from a directional light, rendered once per light with the depth only rasterizer
+//A point is in shadow if the map holds something closer to the light at its position
+class ShadowMap {
+private:
+	int size_;								//Width and height in texels
+	Mat4f matrix_;							//Model space to the light's clip space (orthographic)
+	std::vector<float> depth_;
+	int pitch_;								//Floats between two rows of depth_
+	float bias_;							//Depth offset that keeps surfaces from shadowing themselves
+
+public:
+	ShadowMap();
+	ShadowMap(const Model*, const Vec3f&, const int =1024);
+
+	int size() const;
+	Vec3f project(const Vec3f&) const;
+	float lit(const float, const float, const float, const int =1) const;
+};
+
+#endif //__SHADOWMAP_H__
\ No newline at end of file
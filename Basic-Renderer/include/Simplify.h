@@ -0,0 +1,30 @@
+#ifndef __SIMPLIFY_H__
+#define __SIMPLIFY_H__
+
+#include "Geometry.h"
+#include "Model.h"
+#include "Transform.h"
+
+#include <vector>
+
+//Reduce a model to about targetFaces triangles using quadric error metric edge collapses (Garland & Heckbert)
+//Polygons are triangulated first, so the result only holds triangles
+Model simplify(const Model*, const int);
+
+//Chain of progressively simplified versions of a model, level 0 is the model itself
+class LODChain {
+private:
+	const Model* base_;
+	std::vector<Model> levels_;			//Simplified levels, levels_[i] is level i+1
+
+public:
+	LODChain(const Model*, const std::vector<int>&, const float =0);
+	static std::vector<int> defaultTargets(const Model*, const int =256);
+	static float wantedFaces(const Model*, const Viewport&, const int, const int, const float =16);
+
+	int nLevels() const;
+	const Model* level(int) const;
+	const Model* select(const Viewport&, const int, const int, const float =16) const;
+};
+
+#endif //__SIMPLIFY_H__
\ No newline at end of file
@@ -0,0 +1,38 @@
+#ifndef __STRIPEWRITER_H__
+#define __STRIPEWRITER_H__
+
+#include "Qoi.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+//Writes an image file a stripe of rows at a time from the top, so images far larger than memory can be saved from
+//whatever holds them (see TiledImage). The format follows the file name unless it is given:
+//.qoi is QOI (see Qoi.h), .ppm is binary PPM (P6, or P5 for grayscale, alpha is dropped) and anything else is
+//uncompressed TGA, which can't go past 65535 pixels a side
+class StripeWriter {
+public:
+	enum Format { AUTO, TGA, PPM, QOI };	//AUTO follows the file name
+
+private:
+	Format format_;
+	std::ofstream out_;
+	QoiEncoder qoi_;
+	std::vector<std::uint8_t> converted_;	//A stripe in PPM channel order
+	int width_, height_, bpp_;
+	int rows_;								//Rows written so far
+	bool open_;
+
+public:
+	StripeWriter();
+	~StripeWriter();
+
+	bool open(const std::string&, const int, const int, const int, const Format =AUTO);
+	bool write(const std::uint8_t*, const int, const std::ptrdiff_t);
+	bool close();
+};
+
+#endif //__STRIPEWRITER_H__
\ No newline at end of file
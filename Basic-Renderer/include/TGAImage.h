@@ -1,87 +1,118 @@
-#include <cstdint>
-#include <fstream>
-#include <vector>
-
-//Align struct members every available byte
-#pragma pack(push, 1)
-
-struct TGA_Header {
-	std::uint8_t idlength{};
-	std::uint8_t colormaptype{};
-	std::uint8_t datatypecode{};
-	std::uint16_t colormaporigin{};
-	std::uint16_t colormaplength{};
-	std::uint8_t colormapdepth{};
-	std::uint16_t x_origin{};
-	std::uint16_t y_origin{};
-	std::uint16_t width{};
-	std::uint16_t height{};
-	std::uint8_t bitsperpixel{};
-	std::uint8_t imagedescriptor{};
-};
-
-//Remove alignment requirement
-#pragma pack(pop)
-
-//Struct used for parsing the data TGA file
-struct TGAColor {
-
-	std::uint8_t bgra[4] = {0,0,0,0}; //Bytes are store low to high, hence backward ordering
-	std::uint8_t bytesperpixel{};
-
-	//Default constructor
-	TGAColor() = default;
-	//Constructor with value intialization
-	TGAColor(const std::uint8_t _r, const std::uint8_t _g , const std::uint8_t _b, std::uint8_t _a=255)
-		:bgra{_b,_g,_r,_a}, bytesperpixel(4) {}
-
-	//Constructor that makes a copy, not a copy constructor
-	TGAColor(const std::uint8_t *src, const std::uint8_t _bpp) : bgra{0,0,0,0}, bytesperpixel(_bpp){
-		for(int i=0;i<_bpp;i++)
-			bgra[i] = src[i];
-	}
-
-	//Overload operator to select color component
-	std::uint8_t& operator[](const int i) { return bgra[i]; }
-
-
-	//Overload operator to adjust the color intensity
-	TGAColor operator*(const double intensity) const{
-		TGAColor result = *this;
-		double clamped = std::max(0.0, std::min(intensity, 1.0));
-		for(int i=0; i<4; i++) result.bgra[i] = bgra[i]*clamped;
-		return result;
-	}
-
-};
-
-
-class TGAImage {
-protected:
-	std::vector<std::uint8_t> data;
-	int width;
-	int height;
-	int bytesPerPixel;
-
-	bool load_rle_data(std::ifstream&);
-	bool unload_rle_data(std::ofstream &) const;
-
-public:
-	enum Format { GRAYSCALE=1, RGB=3, RGBA=4};
-
-	TGAImage();
-	TGAImage(const int, const int, const int);
-	bool read_tga_file(const std::string);
-	bool write_tga_file(const std::string, const bool =true, const bool =true) const;
-	void flip_horizontally();
-	void flip_vertically();
-	void scale(const int, const int);
-	TGAColor get(const int, const int) const;
-	void set(const int, const int, const TGAColor &);
-	int get_width() const;
-	int get_height() const;
-	int get_bytespp();
-	std::uint8_t* buffer();
-	void clear();
-	void getInfo();
-};
+#ifndef __TGAIMAGE_H__
+#define __TGAIMAGE_H__
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+//Align struct members every available byte
+#pragma pack(push, 1)
+
+struct TGA_Header {
+	std::uint8_t idlength{};
+	std::uint8_t colormaptype{};
+	std::uint8_t datatypecode{};
+	std::uint16_t colormaporigin{};
+	std::uint16_t colormaplength{};
+	std::uint8_t colormapdepth{};
+	std::uint16_t x_origin{};
+	std::uint16_t y_origin{};
+	std::uint16_t width{};
+	std::uint16_t height{};
+	std::uint8_t bitsperpixel{};
+	std::uint8_t imagedescriptor{};
+};
+
+//Remove alignment requirement
+#pragma pack(pop)
+
+//Struct used for parsing the data TGA file
+struct TGAColor {
+
+	std::uint8_t bgra[4] = {0,0,0,0}; //Bytes are store low to high, hence backward ordering
+	std::uint8_t bytesperpixel{};
+
+	//Default constructor
+	TGAColor() = default;
+	//Constructor with value intialization
+	TGAColor(const std::uint8_t _r, const std::uint8_t _g , const std::uint8_t _b, std::uint8_t _a=255)
+		:bgra{_b,_g,_r,_a}, bytesperpixel(4) {}
+
+	//Constructor that makes a copy, not a copy constructor
+	TGAColor(const std::uint8_t *src, const std::uint8_t _bpp) : bgra{0,0,0,0}, bytesperpixel(_bpp){
+		for(int i=0;i<_bpp;i++)
+			bgra[i] = src[i];
+	}
+
+	//Overload operator to select color component
+	std::uint8_t& operator[](const int i) { return bgra[i]; }
+
+
+	//Overload operator to adjust the color intensity
+	TGAColor operator*(const double intensity) const{
+		TGAColor result = *this;
+		double clamped = std::max(0.0, std::min(intensity, 1.0));
+		for(int i=0; i<4; i++) result.bgra[i] = bgra[i]*clamped;
+		return result;
+	}
+
+};
+
+
+struct MappedFile;
+
+class TGAImage {
+protected:
+	std::vector<std::uint8_t> data;
+	//The mapped file must not be truncated or rewritten while an image maps it: reading pixels past a truncated end
+	//raises SIGBUS, and pages not read yet may show the new contents. Only map files nothing else writes to
+	std::shared_ptr<const MappedFile> mapping;	//File the pixels are read from in place, see map_tga_file
+	const std::uint8_t* view;					//Pixels inside mapping, null if the image owns its data
+	int width;
+	int height;
+	int bytesPerPixel;
+	int origin;									//Corner of the picture the data starts at, see Origin
+
+	bool load_rle_data(const std::uint8_t*, const size_t);
+	bool unload_rle_data(std::ostream &, const int) const;
+	const std::uint8_t* pixels() const;
+	void detach();
+
+public:
+	enum Format { GRAYSCALE=1, RGB=3, RGBA=4};
+	//Where the first row and column of the data lie, as TGA's image descriptor bits 5 (top) and 4 (right)
+	//get() and set() take coordinates from the top left whatever the origin, the data is only reordered on request
+	enum Origin { BOTTOM_LEFT=0x00, BOTTOM_RIGHT=0x10, TOP_LEFT=0x20, TOP_RIGHT=0x30};
+	//Resampling filters for scale(), see Resample.cpp
+	enum Filter { NEAREST, BOX, BILINEAR, LANCZOS3};
+
+	TGAImage();
+	TGAImage(const int, const int, const int);
+	bool read_tga_file(const std::string);
+	bool read_tga(std::istream&);
+	bool map_tga_file(const std::string);
+	bool read_qoi_file(const std::string);
+	bool read_ppm_file(const std::string);
+	bool write_tga_file(const std::string, const bool =true, const bool =true, const int =0) const;
+	bool write_tga(std::ostream&, const bool =true, const bool =true, const int =0) const;
+	bool write_qoi_file(const std::string, const bool =true) const;
+	bool write_ppm_file(const std::string, const bool =true) const;
+	void flip_horizontally();
+	void flip_vertically();
+	void scale(const int, const int, const Filter =BILINEAR, const int =0);
+	void scale(TGAImage&, const int, const int, const Filter =BILINEAR, const int =0) const;
+	TGAColor get(const int, const int) const;
+	void set(const int, const int, const TGAColor &);
+	int get_width() const;
+	int get_height() const;
+	int get_bytespp() const;
+	Origin get_origin() const;
+	void set_origin(const Origin);
+	std::uint8_t* buffer();
+	const std::uint8_t* buffer() const;
+	void clear();
+	void getInfo();
+};
+
+#endif //__TGAIMAGE_H__
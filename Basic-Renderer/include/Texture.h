@@ -0,0 +1,44 @@
+#ifndef __TEXTURE_H__
+#define __TEXTURE_H__
+
+#include "TGAImage.h"
+
+#include <cstdint>
+#include <vector>
+
+#define TEXTURE_TILE 4					//Texels are stored in TEXTURE_TILE x TEXTURE_TILE tiles, one 64 byte cache line each
+
+//Read only texture for shaders, built once from a TGAImage
+//Every mip level is stored as 32 bit BGRA texels in square tiles, so the 2x2 footprint of a bilinear sample touches one
+//cache line most of the time and never more than four, whatever the direction the texture is walked in
+//Coordinates repeat outside [0,1), v=0 is the picture's top row (see TGAImage::get), OBJ texture coordinates need 1-v
+class Texture {
+private:
+	struct Level {
+		int width, height;
+		int tilesX;							//Tiles per row of tiles
+		int offset;							//Index of the level's first texel in texels_
+	};
+
+	std::vector<Level> levels_;
+	std::vector<std::uint32_t> texels_;		//Every level back to back, each level starts on a cache line
+	int base_;								//Index of the first cache aligned texel of texels_
+
+	int index(const Level&, const int, const int) const;
+	std::uint32_t texel(const Level&, const int, const int) const;
+	void bilinear(const Level&, const float, const float, float*) const;
+
+public:
+	Texture();
+	Texture(const TGAImage&);
+
+	bool empty() const;
+	int width() const;
+	int height() const;
+	int nLevels() const;
+	float lod(const float, const float, const float, const float) const;
+	TGAColor sample(const float, const float, const float =0) const;
+	void sample4(const float*, const float*, const float, std::uint32_t*) const;
+};
+
+#endif //__TEXTURE_H__
\ No newline at end of file
@@ -0,0 +1,164 @@
+#ifndef __TILERASTERIZER_H__
+#define __TILERASTERIZER_H__
+
+#include "Geometry.h"
+#include "TGAImage.h"
+#include "my_gl.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#define TILE_SIZE 64					//Width and height of a tile in pixels, a tile's color and depth fit in L2
+#define HIZ_BLOCK 8						//Each tile keeps the farthest depth of every HIZ_BLOCK x HIZ_BLOCK block
+#define HIZ_BLOCKS (TILE_SIZE/HIZ_BLOCK)		//Blocks along each side of a tile
+
+//Sort-middle rasterizer: triangles are collected and binned by the screen tiles they touch, then worker threads
+//draw whole tiles into tile sized buffers and copy the finished tiles into the image
+//Tiles don't overlap, so no two threads ever write the same pixel and nothing is locked
+//Each tile draws its triangles in the order they were added, the image is the same as drawing them one by one
+//Triangles can be grouped in clusters: with occlusion culling on, a tile skips a whole cluster (and any triangle)
+//that lies behind what the tile already holds, so clusters should be added roughly front to back
+//Triangles are either flat colored or carry varyings for a shader, draw() takes the shader as a template parameter
+class TileRasterizer {
+private:
+	struct Triangle {
+		Vec3f pts[3];
+		TGAColor color;
+		int cluster;						//-1 if added outside a cluster
+		int varyings;						//Offset of the triangle's varyings, -1 if it is flat colored
+	};
+
+	struct Bounds {
+		Vec3f min, max;						//Screen space box of a cluster
+	};
+
+	int width_, height_;
+	int tilesX_, tilesY_;
+	int nThreads_;
+	bool occlusion_;
+	std::vector<Triangle> triangles_;
+	std::vector<Bounds> clusters_;
+	std::vector<std::vector<int>> bins_;	//Triangles touching each tile, in the order they were added
+	std::vector<float> varyings_;			//Varyings of the shaded triangles, back to back
+
+	void push(const Vec3f*, const TGAColor&, const float*, const int);
+	template<class Draw> void drawAll(TGAImage&, const Draw&) const;
+	template<class Draw> void drawTiles(TGAImage&, std::atomic<int>&, const Draw&) const;
+
+	static bool hizRange(const Vec3f&, const Vec3f&, const RenderTarget&, int*);
+	static bool occluded(const float*, const int*, const float);
+	static void updateHiZ(float*, const float*, const int*);
+
+public:
+	TileRasterizer(const int, const int, const int =0, const bool =true);
+
+	void beginCluster(const Vec3f&, const Vec3f&);
+	void add(const Vec3f*, const TGAColor&);
+	void add(const Vec3f*, const float*, const int);
+	void draw(TGAImage&) const;
+	template<class S> void draw(TGAImage&, const S&) const;
+	void clear();
+	int nTriangles() const;
+};
+
+//Draw every queued triangle into the image with shader S (see Shader.h), flat colored triangles keep their color
+//The image must be width x height, pixels no triangle covers keep the image's color
+template<class S>
+void TileRasterizer::draw(TGAImage& image, const S& shader) const{
+	drawAll(image, [&](const Triangle& t, RenderTarget& target){
+		if(t.varyings < 0) triangle(t.pts, t.color, target);
+		else triangle(t.pts, &varyings_[t.varyings], shader, target);
+	});
+}
+
+//Run drawTiles on nThreads threads until every tile is done
+template<class Draw>
+void TileRasterizer::drawAll(TGAImage& image, const Draw& draw) const{
+	if(image.get_width() != width_ || image.get_height() != height_) return;
+
+	std::atomic<int> next(0);
+	std::vector<std::thread> workers;
+	for(int i=1; i<nThreads_; i++)
+		workers.emplace_back([&](){ drawTiles(image, next, draw); });
+	drawTiles(image, next, draw);
+	for(std::thread& t : workers) t.join();
+}
+
+//Worker loop: take the next tile until none are left, draw it into local buffers and copy it out
+//draw(triangle, target) rasterizes one triangle into the tile
+//With occlusion culling the tile keeps a coarse z-buffer of its blocks' farthest depths, refreshed where a cluster drew
+//once the cluster is done. A cluster or triangle whose nearest depth is behind it everywhere it reaches is skipped
+template<class Draw>
+void TileRasterizer::drawTiles(TGAImage& image, std::atomic<int>& next, const Draw& draw) const{
+	const int bpp = image.get_bytespp();
+	const int imagePitch = width_*bpp;
+	std::uint8_t* pixels = image.buffer();
+
+	std::vector<std::uint8_t> color(TILE_SIZE*TILE_SIZE*bpp);
+	std::vector<float> depth(TILE_SIZE*TILE_SIZE);
+	float hiz[HIZ_BLOCKS*HIZ_BLOCKS];
+
+	RenderTarget target;
+	target.color = color.data();
+	target.depth = depth.data();
+	target.colorPitch = TILE_SIZE*bpp;
+	target.depthPitch = TILE_SIZE;
+	target.bytesPerPixel = bpp;
+
+	for(int tile = next++; tile < tilesX_*tilesY_; tile = next++){
+		const std::vector<int>& bin = bins_[tile];
+		if(bin.empty()) continue;
+
+		target.x0 = (tile%tilesX_)*TILE_SIZE;
+		target.y0 = (tile/tilesX_)*TILE_SIZE;
+		target.width = std::min(TILE_SIZE, width_-target.x0);
+		target.height = std::min(TILE_SIZE, height_-target.y0);
+		const int rowBytes = target.width*bpp;
+
+		//Start from what the image holds so uncovered pixels are left alone
+		for(int y=0; y<target.height; y++)
+			std::memcpy(&color[y*target.colorPitch], pixels+(target.y0+y)*imagePitch+target.x0*bpp, rowBytes);
+		std::fill(depth.begin(), depth.end(), FLT_MAX);
+
+		if(!occlusion_){
+			for(int i : bin) draw(triangles_[i], target);
+		}else{
+			//Depth past the edge of a partial tile is never drawn, make it the nearest so it doesn't hold blocks open
+			for(int y=0; y<TILE_SIZE; y++)
+				for(int x=(y<target.height ? target.width : 0); x<TILE_SIZE; x++)
+					depth[y*TILE_SIZE+x] = -FLT_MAX;
+			std::fill(hiz, hiz+HIZ_BLOCKS*HIZ_BLOCKS, FLT_MAX);
+
+			int cluster = -1;
+			bool skip = false;
+			int range[4];
+			for(int i : bin){
+				const Triangle& t = triangles_[i];
+				if(t.cluster != cluster){
+					if(cluster >= 0 && !skip && hizRange(clusters_[cluster].min, clusters_[cluster].max, target, range))
+						updateHiZ(hiz, depth.data(), range);
+					cluster = t.cluster;
+					skip = cluster >= 0 && hizRange(clusters_[cluster].min, clusters_[cluster].max, target, range)
+						&& occluded(hiz, range, clusters_[cluster].min.z);
+				}
+				if(skip) continue;
+
+				Vec3f min(std::min({t.pts[0].x, t.pts[1].x, t.pts[2].x}), std::min({t.pts[0].y, t.pts[1].y, t.pts[2].y}),
+							std::min({t.pts[0].z, t.pts[1].z, t.pts[2].z}));
+				Vec3f max(std::max({t.pts[0].x, t.pts[1].x, t.pts[2].x}), std::max({t.pts[0].y, t.pts[1].y, t.pts[2].y}), 0);
+				if(hizRange(min, max, target, range) && occluded(hiz, range, min.z)) continue;
+
+				draw(t, target);
+			}
+		}
+
+		for(int y=0; y<target.height; y++)
+			std::memcpy(pixels+(target.y0+y)*imagePitch+target.x0*bpp, &color[y*target.colorPitch], rowBytes);
+	}
+}
+
+#endif //__TILERASTERIZER_H__
\ No newline at end of file
@@ -0,0 +1,74 @@
+#ifndef __TILEDIMAGE_H__
+#define __TILEDIMAGE_H__
+
+#include "TGAImage.h"
+#include "ImageView.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+//Image stored as square tiles that are only allocated once something is drawn into them, for pictures larger than a
+//TGAImage can hold (a single vector, 65535 pixels a side in a TGA file) or than memory
+//Tiles live in memory, or in a scratch file when one is given: then at most maxResident tiles are mapped at a time
+//and the least recently used one is unmapped to make room, the system writes it back to the file. Memory stays bounded
+//whatever the size of the image. Untouched tiles read as 0 and cost nothing, the file is sparse
+//Rows go from the top, as in TGAImage's data with a top left origin. Not thread safe
+class TiledImage {
+private:
+	struct Tile {
+		std::uint8_t* pixels;				//Null until first drawn into, or while unmapped
+		bool used;							//Drawn into at least once
+		std::list<int>::iterator lru;		//Place in lru_ while mapped
+	};
+
+	int width_, height_;
+	int bytesPerPixel_;
+	int tileSize_;							//Width and height of a tile in pixels
+	int tilesX_, tilesY_;
+	size_t tileBytes_;						//Bytes a tile takes, whole pages when backed by a file
+	size_t maxResident_;
+	std::vector<Tile> tiles_;
+	std::list<int> lru_;					//Mapped tiles, most recently used first
+	std::vector<std::unique_ptr<std::uint8_t[]>> memory_;	//Tiles of an image without a file
+	std::string path_;
+	int fd_;								//Scratch file, -1 if tiles live in memory
+
+	void evict();
+
+public:
+	TiledImage(const int, const int, const int, const std::string& ="", const int =256, const int =256);
+	~TiledImage();
+	TiledImage(const TiledImage&) = delete;
+	TiledImage& operator=(const TiledImage&) = delete;
+
+	bool good() const;
+	int get_width() const;
+	int get_height() const;
+	int get_bytespp() const;
+	int tileSize() const;
+	int tilesX() const;
+	int tilesY() const;
+	bool used(const int, const int) const;
+	std::uint8_t* tile(const int, const int);
+	template<TGAImage::Format F> ImageView<F> view(const int, const int);
+	TGAColor get(const int, const int);
+	void set(const int, const int, const TGAColor&);
+	bool readRows(const int, const int, std::uint8_t*);
+	bool write(const std::string&, const bool =true);
+};
+
+//Typed view of tile tx,ty, clipped to the image (see tile for how long it stays valid)
+//Empty if the image's pixels aren't of format F
+template<TGAImage::Format F>
+ImageView<F> TiledImage::view(const int tx, const int ty){
+	if(bytesPerPixel_ != F) return ImageView<F>();
+	std::uint8_t* pixels = tile(tx, ty);
+	if(!pixels) return ImageView<F>();
+	return ImageView<F>(pixels, std::min(tileSize_, width_-tx*tileSize_), std::min(tileSize_, height_-ty*tileSize_), tileSize_*F);
+}
+
+#endif //__TILEDIMAGE_H__
\ No newline at end of file
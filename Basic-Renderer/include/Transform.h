@@ -0,0 +1,43 @@
+#ifndef __TRANSFORM_H__
+#define __TRANSFORM_H__
+
+#include "Geometry.h"
+
+#include <vector>
+
+//Per axis linear mapping from model space to screen space: screen = v*scale + offset
+//Screen z is a depth value, smaller values are closer to the viewer
+struct Viewport {
+	Vec3f scale;
+	Vec3f offset;
+
+	Viewport();
+	Viewport(const Vec3f&, const Vec3f&);
+
+	static Viewport unit(const int, const int);
+	static Viewport fit(const Vec3f&, const Vec3f&, const int, const int, const float =0.05);
+
+	Vec3f apply(const Vec3f&) const;
+	Mat4f clip(const int, const int) const;
+};
+
+//Post transform vertex buffer, one entry per model vertex stored as separate arrays so it can be filled 4 vertices at a time
+struct VertexBuffer {
+	std::vector<float> x, y, z;			//Screen position
+	std::vector<int> ix, iy;			//Screen position truncated to a pixel, used by the line drawer
+	std::vector<Vec4f> clip;			//Clip space position, only filled by projectVertices
+										//The screen position of a vertex behind the near plane is meaningless
+
+	int size() const;
+	void resize(const int);
+};
+
+void bounds(const std::vector<Vec3f>&, Vec3f&, Vec3f&);
+void transformVertices(const std::vector<Vec3f>&, const Viewport&, VertexBuffer&);
+void projectVertices(const std::vector<Vec3f>&, const Mat4f&, const int, const int, VertexBuffer&);
+Vec3f toScreen(const Vec4f&, const int, const int);
+void clipPolygon(const std::vector<float>&, std::vector<float>&, const int, const float, const float);
+bool clipSegment(Vec4f&, Vec4f&, const float, const float);
+bool inGuardBand(const Vec4f&, const float, const float);
+
+#endif //__TRANSFORM_H__
\ No newline at end of file
@@ -0,0 +1,86 @@
+#ifndef __VEC4_H__
+#define __VEC4_H__
+
+#include "Vec3.h"
+
+#include <ostream>
+
+template <typename T>
+class Vec4;
+
+template <typename T>
+std::ostream& operator<<(std::ostream&, const Vec4<T> &);
+
+
+//Homogeneous vector, used for points in clip space
+template <typename T>
+class Vec4 {
+
+public:
+	T x, y, z, w;
+
+	Vec4();
+	Vec4(T _x, T _y, T _z, T _w);
+	Vec4(const Vec3<T>&, T _w);
+
+	Vec3<T> xyz() const;
+
+	Vec4<T> operator* (const T &) const;
+	T dot(const Vec4<T> &) const;
+	Vec4<T> operator- (const Vec4<T> &) const;
+	Vec4<T> operator+ (const Vec4<T> &) const;
+
+	friend std::ostream& operator<< <>(std::ostream&, const Vec4<T> &);
+
+};
+
+//Default constructor
+template <typename T>
+Vec4<T>::Vec4(): x(T(0)), y(T(0)), z(T(0)), w(T(0)){};
+
+//Four value constructor
+template <typename T>
+Vec4<T>::Vec4(T _x, T _y, T _z, T _w) : x(_x), y(_y), z(_z), w(_w){};
+
+//Extend a Vec3, w is 1 for points and 0 for directions
+template <typename T>
+Vec4<T>::Vec4(const Vec3<T>& v, T _w) : x(v.x), y(v.y), z(v.z), w(_w){};
+
+//First three components
+template <typename T>
+Vec3<T> Vec4<T>::xyz() const{
+	return Vec3<T>(x, y, z);
+}
+
+//Overload multiplication by scalar
+template <typename T>
+Vec4<T> Vec4<T>::operator* (const T &f) const{
+	return Vec4<T>(x*f, y*f, z*f, w*f);
+}
+
+//Dot product
+template <typename T>
+T Vec4<T>::dot(const Vec4<T> &v) const{
+	return x*v.x+y*v.y+z*v.z+w*v.w;
+}
+
+//Overload subtraction by vector
+template <typename T>
+Vec4<T> Vec4<T>::operator- (const Vec4<T> &v) const{
+	return Vec4<T>(x-v.x, y-v.y, z-v.z, w-v.w);
+}
+
+//Overload addition by vector
+template <typename T>
+Vec4<T> Vec4<T>::operator+ (const Vec4<T> &v) const{
+	return Vec4<T>(x+v.x, y+v.y, z+v.z, w+v.w);
+}
+
+template<typename T>
+std::ostream& operator<<(std::ostream& os, const Vec4<T> &v){
+	os << "[" << v.x << "," << v.y << "," << v.z << "," << v.w << "]";
+	return os;
+}
+
+
+#endif //__VEC4_H__
\ No newline at end of file
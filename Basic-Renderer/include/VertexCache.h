@@ -0,0 +1,12 @@
+#ifndef __VERTEXCACHE_H__
+#define __VERTEXCACHE_H__
+
+#include "Geometry.h"
+
+#include <vector>
+
+bool optimizeFaceOrder(std::vector<std::vector<int>>&, const int, const int =32, std::vector<int>* =nullptr);
+std::vector<int> renumberVertices(std::vector<Vec3f>&, std::vector<std::vector<int>>&);
+float cacheMissRatio(const std::vector<std::vector<int>>&, const int, const int =16);
+
+#endif //__VERTEXCACHE_H__
\ No newline at end of file
@@ -1,21 +1,40 @@
-#ifndef __MODEL_H__
-#define __MODEL_H__
-
-#include "Geometry.h"
-#include <vector>
-
-
-class Model {
-private:
-	std::vector<Vec3f> vertices_;
-	std::vector<std::vector<int>> faces_;
-public:
-	Model(const char*);
-	int nVerts() const;
-	int nFaces() const;
-	Vec3f vert(int) const;
-	std::vector<int> face(int) const;
-	void debug();
-};
-
+#ifndef __MODEL_H__
+#define __MODEL_H__
+
+#include "Geometry.h"
+#include <vector>
+
+
+class Model {
+private:
+	std::vector<Vec3f> vertices_;
+	std::vector<std::vector<int>> faces_;
+	std::vector<Vec2f> uvs_;				//Texture coordinates (vt)
+	std::vector<Vec3f> normals_;			//Vertex normals (vn), computed from the faces if the file has none
+	std::vector<std::vector<int>> faceUVs_;			//Texture coordinate of each face corner, -1 if it has none
+	std::vector<std::vector<int>> faceNormals_;		//Normal of each face corner
+	Vec3f bboxMin_, bboxMax_;				//Axis aligned bounding box, computed at load
+
+	void computeNormals();
+public:
+	Model(const char*);
+	Model(const std::vector<Vec3f>&, const std::vector<std::vector<int>>&);
+	int nVerts() const;
+	int nFaces() const;
+	Vec3f vert(int) const;
+	std::vector<int> face(int) const;
+	const std::vector<Vec3f>& verts() const;
+	int nUVs() const;
+	Vec2f uv(int) const;
+	Vec3f normal(int) const;
+	int faceVert(int, int) const;
+	int faceUV(int, int) const;
+	int faceNormal(int, int) const;
+	Vec3f bboxMin() const;
+	Vec3f bboxMax() const;
+	void optimize();
+	bool write_obj_file(const char*) const;
+	void debug();
+};
+
 #endif // __MODEL_H__
\ No newline at end of file
@@ -0,0 +1,278 @@
+#ifndef __MY_GL_H__
+#define __MY_GL_H__
+
+#include "Geometry.h"
+#include "TGAImage.h"
+#include "ImageView.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define GUARD_BAND 16384				//Triangles reaching further from the origin than this (in pixels) are dropped, this keeps
+										//edge values in 32 bits. Geometry that can go further must be clipped first (see clipPolygon)
+#define SUBPIXEL_BITS 4					//Vertices are snapped to 1/16th of a pixel
+#define SUBPIXEL (1 << SUBPIXEL_BITS)
+#define BLOCK 4							//The rasterizer walks the screen in BLOCK x BLOCK pixel blocks
+
+//Color and depth buffers the rasterizer draws into
+//A target can cover only part of the screen, x0,y0 is the screen position of its first pixel
+struct RenderTarget {
+	std::uint8_t* color;			//Row 0 of the color buffer, null if only depth is drawn
+	float* depth;					//Row 0 of the depth buffer, smaller values are closer
+	int colorPitch;					//Bytes between two rows of color
+	int depthPitch;					//Floats between two rows of depth, always a multiple of 4
+	int bytesPerPixel;
+	int x0, y0;
+	int width, height;
+
+	RenderTarget();
+	RenderTarget(TGAImage&, std::vector<float>&);
+};
+
+//Attribute interpolated linearly in screen space: value(x,y) = origin + dx*(x-x0) + dy*(y-y0)
+//Built from the same snapped vertex positions as the rasterizer's edges so it matches the pixels drawn
+struct Plane {
+	float origin, dx, dy;
+	float x0, y0;
+
+	Plane();
+	Plane(const Vec3f*, const float, const float, const float);
+
+	float at(const float x, const float y) const { return origin + dx*(x-x0) + dy*(y-y0); }
+};
+
+int paddedPitch(const int);
+void triangle(const Vec3f*, const TGAColor&, RenderTarget&);
+void depthTriangle(const Vec3f*, RenderTarget&);
+template<class S> void triangle(const Vec3f*, const float*, const S&, RenderTarget&);
+
+//Store the masked pixels of a block row, colors[i] goes to pixel i (see rasterizeTriangle)
+//Typed pixels make every store a fixed size move
+template<TGAImage::Format F>
+static inline void writeBlock(std::uint8_t* crow, const int mask, const TGAColor* colors){
+	Pixel<F>* row = reinterpret_cast<Pixel<F>*>(crow);
+	for(int i=0; i<BLOCK; i++)
+		if(mask & (1 << i)) row[i] = Pixel<F>(colors[i]);
+}
+
+//Same for a target with bytesPerPixel bytes per pixel, one switch per block instead of one per pixel
+static inline void writeBlock(std::uint8_t* crow, const int mask, const TGAColor* colors, const int bytesPerPixel){
+	switch(bytesPerPixel){
+		case TGAImage::RGBA: writeBlock<TGAImage::RGBA>(crow, mask, colors); break;
+		case TGAImage::RGB: writeBlock<TGAImage::RGB>(crow, mask, colors); break;
+		default: writeBlock<TGAImage::GRAYSCALE>(crow, mask, colors);
+	}
+}
+
+//Edge function E(x,y) = stepX*x + stepY*y + offset, evaluated at pixel centers
+//E is positive inside the triangle, offset already holds the fill rule bias so inside means E >= 0
+struct EdgeFunction {
+	std::int64_t stepX, stepY, offset;
+
+	//Edge from a to b, coordinates in subpixels
+	EdgeFunction(const std::int64_t ax, const std::int64_t ay, const std::int64_t bx, const std::int64_t by){
+		std::int64_t a = ay-by;
+		std::int64_t b = bx-ax;
+		//Fill rule: a pixel center exactly on an edge shared by two triangles belongs to only one of them
+		bool owns = a > 0 || (a == 0 && b < 0);
+		stepX = a*SUBPIXEL;
+		stepY = b*SUBPIXEL;
+		offset = a*(SUBPIXEL/2-ax) + b*(SUBPIXEL/2-ay) - (owns ? 0 : 1);
+	}
+
+	std::int64_t at(const int x, const int y) const { return stepX*x + stepY*y + offset; }
+};
+
+//Rasterize a triangle, pts are screen coordinates and depth
+//Both windings are drawn, the z-buffer test keeps the closest surface
+//The bounding box is walked in 4x4 blocks: blocks outside an edge are skipped whole, blocks inside every edge skip
+//the edge tests, only blocks on an edge test each pixel (4 at a time with SSE2)
+//Covered pixels that pass the depth test are handed to fill(x, y, mask, crow) a block row at a time: bit i of mask is
+//pixel (x+i, y) and crow points to pixel x of the row's color (null for a depth only target without color)
+//Fill is a template parameter so it is inlined
+template<class Fill>
+void rasterizeTriangle(const Vec3f* pts, RenderTarget& target, const Fill& fill){
+
+	for(int i=0; i<3; i++)
+		if(!(std::fabs(pts[i].x) < GUARD_BAND && std::fabs(pts[i].y) < GUARD_BAND)) return;
+
+	//Snap to the subpixel grid
+	std::int64_t X[3], Y[3];
+	for(int i=0; i<3; i++){
+		X[i] = std::lrint(pts[i].x*SUBPIXEL);
+		Y[i] = std::lrint(pts[i].y*SUBPIXEL);
+	}
+
+	//Make the winding counter clockwise so the inside is positive
+	int i1 = 1, i2 = 2;
+	std::int64_t area = (X[1]-X[0])*(Y[2]-Y[0]) - (X[2]-X[0])*(Y[1]-Y[0]);
+	if(area == 0) return;
+	if(area < 0){
+		std::swap(i1, i2);
+		area = -area;
+	}
+
+	//Pixels whose centers can be inside, clipped to the target
+	int minX = (std::min({X[0], X[1], X[2]})+SUBPIXEL/2-1) >> SUBPIXEL_BITS;
+	int maxX = (std::max({X[0], X[1], X[2]})-SUBPIXEL/2) >> SUBPIXEL_BITS;
+	int minY = (std::min({Y[0], Y[1], Y[2]})+SUBPIXEL/2-1) >> SUBPIXEL_BITS;
+	int maxY = (std::max({Y[0], Y[1], Y[2]})-SUBPIXEL/2) >> SUBPIXEL_BITS;
+	minX = std::max(minX, target.x0);
+	minY = std::max(minY, target.y0);
+	maxX = std::min(maxX, target.x0+target.width-1);
+	maxY = std::min(maxY, target.y0+target.height-1);
+	if(minX > maxX || minY > maxY) return;
+
+	const EdgeFunction edges[3] = {
+		EdgeFunction(X[0], Y[0], X[i1], Y[i1]),
+		EdgeFunction(X[i1], Y[i1], X[i2], Y[i2]),
+		EdgeFunction(X[i2], Y[i2], X[0], Y[0])
+	};
+
+	//Depth plane z = z0 + dzdx*(x-x0) + dzdy*(y-y0)
+	const float fx1 = float(X[i1]-X[0])/SUBPIXEL, fy1 = float(Y[i1]-Y[0])/SUBPIXEL;
+	const float fx2 = float(X[i2]-X[0])/SUBPIXEL, fy2 = float(Y[i2]-Y[0])/SUBPIXEL;
+	const float dz1 = pts[i1].z-pts[0].z, dz2 = pts[i2].z-pts[0].z;
+	const float det = fx1*fy2 - fx2*fy1;
+	const float dzdx = (dz1*fy2 - dz2*fy1)/det;
+	const float dzdy = (dz2*fx1 - dz1*fx2)/det;
+	const float originX = float(X[0])/SUBPIXEL, originY = float(Y[0])/SUBPIXEL;
+	//Rounding can take the plane a little past the vertices, clamping keeps every depth within the triangle's range
+	//so a triangle is never closer than its nearest vertex, which occlusion culling relies on
+	const float zNear = std::min({pts[0].z, pts[1].z, pts[2].z});
+	const float zFar = std::max({pts[0].z, pts[1].z, pts[2].z});
+
+	//Blocks are aligned to the target so a block row never leaves the (padded) depth row
+	const int startX = target.x0 + ((minX-target.x0) & ~(BLOCK-1));
+	const int startY = target.y0 + ((minY-target.y0) & ~(BLOCK-1));
+
+	//How much an edge value can grow or shrink across a block
+	std::int64_t spanHi[3], spanLo[3];
+	for(int k=0; k<3; k++){
+		spanHi[k] = std::max<std::int64_t>(0, edges[k].stepX*(BLOCK-1)) + std::max<std::int64_t>(0, edges[k].stepY*(BLOCK-1));
+		spanLo[k] = std::min<std::int64_t>(0, edges[k].stepX*(BLOCK-1)) + std::min<std::int64_t>(0, edges[k].stepY*(BLOCK-1));
+	}
+
+#if defined(__SSE2__)
+	__m128i laneStep[3];
+	for(int k=0; k<3; k++)
+		laneStep[k] = _mm_setr_epi32(0, int(edges[k].stepX), int(edges[k].stepX*2), int(edges[k].stepX*3));
+	const __m128 zLane = _mm_setr_ps(0, dzdx, dzdx*2, dzdx*3);
+	const __m128 zMin = _mm_set1_ps(zNear), zMax = _mm_set1_ps(zFar);
+	const __m128i laneBits = _mm_setr_epi32(1, 2, 4, 8);
+#endif
+
+	const int bpp = target.bytesPerPixel;
+
+	for(int by=startY; by<=maxY; by+=BLOCK){
+		for(int bx=startX; bx<=maxX; bx+=BLOCK){
+
+			//Trivial reject and accept from the block's extreme edge values
+			std::int64_t corner[3];
+			int straddle = 0;
+			bool outside = false;
+			for(int k=0; k<3; k++){
+				corner[k] = edges[k].at(bx, by);
+				if(corner[k]+spanHi[k] < 0) outside = true;
+				if(corner[k]+spanLo[k] < 0) straddle |= 1 << k;
+			}
+			if(outside) continue;
+
+			//Columns of the block that are inside the bounding box and the target
+			int columns = 0;
+			for(int i=0; i<BLOCK; i++)
+				if(bx+i >= minX && bx+i <= maxX) columns |= 1 << i;
+
+			for(int j=0; j<BLOCK; j++){
+				const int y = by+j;
+				if(y < minY || y > maxY) continue;
+
+				float* zrow = target.depth + (y-target.y0)*target.depthPitch + (bx-target.x0);
+				std::uint8_t* crow = target.color ? target.color + (y-target.y0)*target.colorPitch + (bx-target.x0)*bpp : nullptr;
+				const float z = pts[0].z + dzdx*(bx+0.5f-originX) + dzdy*(y+0.5f-originY);
+				int mask = columns;
+
+#if defined(__SSE2__)
+				//Only edges crossing the block need testing, their values stay small enough for 32 bits
+				if(straddle){
+					__m128i acc = _mm_setzero_si128();
+					for(int k=0; k<3; k++){
+						if(!(straddle & (1 << k))) continue;
+						__m128i e = _mm_add_epi32(_mm_set1_epi32(int(corner[k]+edges[k].stepY*j)), laneStep[k]);
+						acc = _mm_or_si128(acc, e);
+					}
+					mask &= ~_mm_movemask_ps(_mm_castsi128_ps(acc));		//Sign bit set means outside an edge
+					if(!mask) continue;
+				}
+
+				__m128 zv = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_set1_ps(z), zLane), zMin), zMax);
+				__m128 old = _mm_loadu_ps(zrow);
+				mask &= _mm_movemask_ps(_mm_cmplt_ps(zv, old));
+				if(!mask) continue;
+
+				__m128 write = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(mask), laneBits), laneBits));
+				_mm_storeu_ps(zrow, _mm_or_ps(_mm_and_ps(write, zv), _mm_andnot_ps(write, old)));
+#else
+				for(int i=0; i<BLOCK; i++){
+					if(!(mask & (1 << i))) continue;
+					bool inside = true;
+					for(int k=0; k<3; k++)
+						if(straddle & (1 << k)) inside = inside && corner[k]+edges[k].stepY*j+edges[k].stepX*i >= 0;
+					float zi = std::min(std::max(z+dzdx*i, zNear), zFar);
+					if(inside && zi < zrow[i]) zrow[i] = zi;
+					else mask &= ~(1 << i);
+				}
+#endif
+
+				fill(bx, y, mask, crow);
+			}
+		}
+	}
+}
+
+//Shade a triangle with a shader S (see Shader.h), pts are screen coordinates and depth
+//varyings holds 1+S::nVaryings floats per vertex: 1/w, then each varying divided by w. Interpolating those linearly on
+//screen and dividing by the interpolated 1/w gives perspective correct varyings, which S::fragments turns into colors
+//The shader is a template parameter: the varying count is known at compile time and the shader is inlined
+template<class S>
+void triangle(const Vec3f* pts, const float* varyings, const S& shader, RenderTarget& target){
+	const int N = S::nVaryings;
+	Plane planes[1+N];
+	for(int k=0; k<=N; k++)
+		planes[k] = Plane(pts, varyings[k], varyings[(1+N)+k], varyings[2*(1+N)+k]);
+
+	const int bpp = target.bytesPerPixel;
+	rasterizeTriangle(pts, target, [&](int x, int y, int mask, std::uint8_t* crow){
+		float varying[BLOCK*(N > 0 ? N : 1)];
+		float ddx[N > 0 ? N : 1], ddy[N > 0 ? N : 1];
+		TGAColor colors[BLOCK];
+		const float py = y+0.5f;
+		int first = -1;
+		for(int i=0; i<BLOCK; i++){
+			if(!(mask & (1 << i))) continue;
+			const float px = x+i+0.5f;
+			const float w = 1/planes[0].at(px, py);
+			for(int k=0; k<N; k++) varying[i*N+k] = planes[k+1].at(px, py)*w;
+			if(first < 0) first = i;
+		}
+		//Derivatives of v = V/W at the first fragment: dv/dx = (dV/dx - v*dW/dx)/W
+		if(S::derivatives){
+			const float w = 1/planes[0].at(x+first+0.5f, py);
+			for(int k=0; k<N; k++){
+				ddx[k] = (planes[k+1].dx - varying[first*N+k]*planes[0].dx)*w;
+				ddy[k] = (planes[k+1].dy - varying[first*N+k]*planes[0].dy)*w;
+			}
+		}
+		shader.fragments(varying, S::derivatives ? ddx : nullptr, S::derivatives ? ddy : nullptr, mask, colors);
+		writeBlock(crow, mask, colors, bpp);
+	});
+}
+
+#endif //__MY_GL_H__
\ No newline at end of file
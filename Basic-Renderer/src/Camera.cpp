@@ -0,0 +1,76 @@
+#include "Camera.h"
+
+#include <algorithm>
+#include <cmath>
+
+#define DEG2RAD 0.017453292519943295f
+
+
+//Default constructor, looks down the negative z axis from z=3 like the old fixed projection did
+Camera::Camera() : eye(0,0,3), target(0,0,0), up(0,1,0), fov(40), height(2), zNear(0.1f), zFar(100) {}
+
+//Camera at eye looking at target, near and far planes should be set to fit the scene
+Camera::Camera(const Vec3f& _eye, const Vec3f& _target, const Vec3f& _up, const float _fov) :
+			eye(_eye), target(_target), up(_up), fov(_fov), height(2), zNear(0.1f), zFar(100) {}
+
+//Unit vector the camera looks along
+Vec3f Camera::direction() const{
+	return (target-eye).normalize();
+}
+
+//World to camera matrix, the camera looks down its negative z axis with y up
+Mat4f Camera::view() const{
+	Vec3f f = direction();
+	Vec3f s = f.cross(up).normalize();
+	Vec3f u = s.cross(f);
+
+	Mat4f r = Mat4f::identity();
+	r.m[0][0] = s.x;  r.m[0][1] = s.y;  r.m[0][2] = s.z;  r.m[0][3] = -s.dot(eye);
+	r.m[1][0] = u.x;  r.m[1][1] = u.y;  r.m[1][2] = u.z;  r.m[1][3] = -u.dot(eye);
+	r.m[2][0] = -f.x; r.m[2][1] = -f.y; r.m[2][2] = -f.z; r.m[2][3] = f.dot(eye);
+	return r;
+}
+
+//Camera to clip matrix for an image of the given aspect ratio (width/height)
+Mat4f Camera::projection(const float aspect) const{
+	Mat4f r;
+	if(fov > 0){
+		float f = 1/std::tan(fov*DEG2RAD/2);
+		r.m[0][0] = f/aspect;
+		r.m[1][1] = f;
+		r.m[2][2] = (zFar+zNear)/(zNear-zFar);
+		r.m[2][3] = 2*zFar*zNear/(zNear-zFar);
+		r.m[3][2] = -1;
+	}else{
+		r.m[0][0] = 2/(height*aspect);
+		r.m[1][1] = 2/height;
+		r.m[2][2] = 2/(zNear-zFar);
+		r.m[2][3] = (zFar+zNear)/(zNear-zFar);
+		r.m[3][3] = 1;
+	}
+	return r;
+}
+
+//Model to clip matrix for a width x height image
+Mat4f Camera::matrix(const int width, const int height) const{
+	return projection(float(width)/height)*view();
+}
+
+//Camera circling the box [min,max]: yaw turns around the y axis and pitch raises the camera (degrees)
+//At distance 1 the box's bounding sphere just fits the view, larger values move the camera back
+//Yaw and pitch 0 look down the negative z axis, the view the models are framed with by default
+Camera Camera::orbit(const Vec3f& min, const Vec3f& max, const float yaw, const float pitch, const float fov, const float distance){
+	Vec3f center = (min+max)*0.5f;
+	float radius = std::max((max-min).length()*0.5f, 1e-6f);
+
+	float dist = fov > 0 ? distance*radius/std::sin(fov*DEG2RAD/2) : distance*radius*2;
+	float cy = std::cos(yaw*DEG2RAD), sy = std::sin(yaw*DEG2RAD);
+	float cp = std::cos(pitch*DEG2RAD), sp = std::sin(pitch*DEG2RAD);
+	Vec3f eye = center + Vec3f(cp*sy, sp, cp*cy)*dist;
+
+	Camera camera(eye, center, std::fabs(sp) > 0.999f ? Vec3f(0,0,-1) : Vec3f(0,1,0), fov);
+	camera.height = radius*2;
+	camera.zNear = std::max(dist-radius, radius*0.01f);
+	camera.zFar = dist+radius;
+	return camera;
+}
\ No newline at end of file
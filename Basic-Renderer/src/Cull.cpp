@@ -0,0 +1,54 @@
+#include "Cull.h"
+
+#include <algorithm>
+
+//Split the faces of a model into clusters of facesPerCluster consecutive faces
+std::vector<Cluster> buildClusters(const Model* model, const int facesPerCluster){
+	std::vector<Cluster> clusters;
+	const int nFaces = model->nFaces();
+	clusters.reserve((nFaces+facesPerCluster-1)/facesPerCluster);
+
+	for(int first=0; first<nFaces; first+=facesPerCluster){
+		Cluster c;
+		c.firstFace = first;
+		c.nFaces = std::min(facesPerCluster, nFaces-first);
+		c.min = c.max = Vec3f(0);
+		bool empty = true;
+		for(int i=first; i<first+c.nFaces; i++){
+			for(int v : model->face(i)){
+				Vec3f p = model->vert(v);
+				if(empty){
+					c.min = c.max = p;
+					empty = false;
+				}
+				c.min = Vec3f(std::min(c.min.x, p.x), std::min(c.min.y, p.y), std::min(c.min.z, p.z));
+				c.max = Vec3f(std::max(c.max.x, p.x), std::max(c.max.y, p.y), std::max(c.max.z, p.z));
+			}
+		}
+		clusters.push_back(c);
+	}
+	return clusters;
+}
+
+//Can any part of the model space box [min,max] be seen through the model to clip matrix mvp
+//The box is out of view when all 8 corners are beyond the same clip plane (the far plane isn't used)
+bool inFrustum(const Mat4f& mvp, const Vec3f& min, const Vec3f& max){
+	int outside[5] = {0,0,0,0,0};				//Corners beyond x=-w, x=w, y=-w, y=w and z=-w
+	for(int i=0; i<8; i++){
+		Vec4f c = mvp*Vec4f((i&1) ? max.x : min.x, (i&2) ? max.y : min.y, (i&4) ? max.z : min.z, 1);
+		outside[0] += c.x < -c.w;
+		outside[1] += c.x > c.w;
+		outside[2] += c.y < -c.w;
+		outside[3] += c.y > c.w;
+		outside[4] += c.z < -c.w;
+	}
+	for(int p=0; p<5; p++)
+		if(outside[p] == 8) return false;
+	return true;
+}
+
+//Does a screen space triangle face away from the viewer
+//Front faces wind counter clockwise on screen (y up), which is counter clockwise seen from +z in model space
+bool backFacing(const Vec3f* pts){
+	return (pts[1].x-pts[0].x)*(pts[2].y-pts[0].y) - (pts[2].x-pts[0].x)*(pts[1].y-pts[0].y) <= 0;
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "EdgeList.h"
+
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+
+
+//Build the unique edge list of a model
+EdgeList::EdgeList(const Model* model) : edges_(), faceNormals_(model->nFaces()) {
+
+	//Key each edge by its sorted vertex pair so (a,b) and (b,a) land in the same slot
+	std::unordered_map<std::uint64_t, int> lookup;
+	lookup.reserve(model->nFaces()*2);				//A closed mesh has about 1.5 edges per triangle (2 per quad)
+	edges_.reserve(model->nFaces()*2);
+
+	for(int i=0; i<model->nFaces(); i++){
+		std::vector<int> face = model->face(i);
+		int n = face.size();
+		if(n < 3) continue;
+
+		//Newell's method gives a usable normal for quads and other polygons that are not quite planar
+		Vec3f normal;
+		for(int j=0; j<n; j++){
+			Vec3f a = model->vert(face[j]);
+			Vec3f b = model->vert(face[(j+1)%n]);
+			normal += Vec3f((a.y-b.y)*(a.z+b.z), (a.z-b.z)*(a.x+b.x), (a.x-b.x)*(a.y+b.y));
+		}
+		faceNormals_[i] = normal.normalize();
+
+		for(int j=0; j<n; j++){
+			int a = face[j];
+			int b = face[(j+1)%n];
+			if(a == b) continue;					//Degenerate edge
+			if(a > b) std::swap(a, b);
+
+			std::uint64_t key = (std::uint64_t(std::uint32_t(a)) << 32) | std::uint32_t(b);
+			auto found = lookup.emplace(key, int(edges_.size()));
+			if(found.second){
+				edges_.push_back({a, b, i, -1, 1});		//First time we see the edge
+			}else{
+				Edge& e = edges_[found.first->second];
+				if(e.nFaces == 1) e.f1 = i;				//Only the first two faces are kept for non-manifold edges
+				e.nFaces++;
+			}
+		}
+	}
+
+}
+
+//Get the edge count
+int EdgeList::nEdges() const{
+	return edges_.size();
+}
+
+//Get an edge at index idx
+const Edge& EdgeList::edge(int idx) const{
+	return edges_[idx];
+}
+
+//Get the normal of a face at index idx
+Vec3f EdgeList::faceNormal(int idx) const{
+	return faceNormals_[idx];
+}
+
+//Get the indices of the edges that pass the filter
+//featureAngle is the dihedral angle in degrees above which an edge counts as a feature edge
+//view is the viewing direction used to find silhouettes (the default looks down the negative z axis)
+std::vector<int> EdgeList::select(const int filter, const float featureAngle, const Vec3f& view) const{
+	std::vector<int> selected;
+	selected.reserve(edges_.size());
+
+	const float cosFeature = std::cos(featureAngle*M_PI/180.);
+
+	for(int i=0; i<nEdges(); i++){
+		const Edge& e = edges_[i];
+
+		//Boundary and non-manifold edges outline the mesh, so every filter keeps them
+		bool keep = filter==ALL || e.f1 < 0 || e.nFaces > 2;
+
+		if(!keep && (filter & FEATURE))
+			keep = faceNormals_[e.f0].dot(faceNormals_[e.f1]) < cosFeature;
+
+		if(!keep && (filter & SILHOUETTE))
+			keep = (faceNormals_[e.f0].dot(view) < 0) != (faceNormals_[e.f1].dot(view) < 0);	//One face points to the viewer, the other away
+
+		if(keep) selected.push_back(i);
+	}
+
+	return selected;
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#include "FrameWriter.h"
+
+//Ring of nFrames width x height images, 2 is enough for rendering and writing to overlap, more absorbs slow writes
+FrameWriter::FrameWriter(const int width, const int height, const int format, const int nFrames) :
+			frames_(nFrames > 0 ? nFrames : 1, TGAImage(width, height, format)), free_(frames_.size()), pending_(frames_.size()),
+			writer_(), failures_(0), finished_(false) {
+	for(int i=0; i<int(frames_.size()); i++) free_.push(i);
+	writer_ = std::thread(&FrameWriter::run, this);
+}
+
+//Waits for the queued frames to be written
+FrameWriter::~FrameWriter(){
+	finish();
+}
+
+//Writer loop: encode and write queued frames in order, then recycle their images
+//Files named .qoi are written as QOI, anything else as RLE TGA
+void FrameWriter::run(){
+	Job job;
+	while(pending_.pop(job)){
+		const size_t n = job.filename.size();
+		const bool qoi = n > 4 && job.filename.compare(n-4, 4, ".qoi") == 0;
+		if(!(qoi ? frames_[job.frame].write_qoi_file(job.filename) : frames_[job.frame].write_tga_file(job.filename))) failures_++;
+		free_.push(job.frame);
+	}
+}
+
+//Take a free image of the ring, cleared to black, waits while all of them are queued for writing
+//Returns its index for frame() and submit()
+int FrameWriter::acquire(){
+	int frame = 0;
+	free_.pop(frame);
+	frames_[frame].clear();
+	return frame;
+}
+
+//Get an image of the ring
+TGAImage& FrameWriter::frame(const int index){
+	return frames_[index];
+}
+
+//Queue an acquired image to be written to filename, it must not be touched until it is acquired again
+void FrameWriter::submit(const int frame, const std::string& filename){
+	pending_.push(Job{frame, filename});
+}
+
+//Write every queued frame and stop the writer thread, returns the number of files that couldn't be written
+int FrameWriter::finish(){
+	if(!finished_){
+		finished_ = true;
+		pending_.close();
+		writer_.join();
+	}
+	return failures_;
+}
\ No newline at end of file
@@ -0,0 +1,175 @@
+#include "ModelStream.h"
+#include "Transform.h"
+
+#include <cstdlib> //std::strtof, std::strtol
+#include <cstring> //std::memchr, std::memmove
+#include <iostream> //std::cerr
+
+
+//Calls fn(lineBegin, lineEnd, lineOffset) for every line of the file starting at offset start
+//The file is read chunkSize bytes at a time, only the current chunk and the unfinished line at its end are held in memory
+//fn returns false to stop reading early
+template <typename Fn>
+static bool forEachLine(const std::string& filename, const std::streamoff start, const std::size_t chunkSize, Fn fn){
+	std::ifstream in(filename, std::ios::binary);
+	if(!in.is_open()){
+		std::cerr << "Can't open file " << filename << "\n";
+		return false;
+	}
+	in.seekg(start);
+
+	std::vector<char> buffer;
+	std::size_t kept = 0;							//Bytes of an unfinished line carried over from the previous chunk
+	std::streamoff bufferOffset = start;			//File offset of buffer[0]
+	bool last = false;
+
+	while(!last){
+		buffer.resize(kept+chunkSize+1);			//+1 for a terminator so number parsing never runs past the data
+		in.read(buffer.data()+kept, chunkSize);
+		if(in.bad()){
+			std::cerr << "An error occured while reading " << filename << "\n";
+			return false;
+		}
+		last = std::size_t(in.gcount()) < chunkSize;
+		std::size_t size = kept+in.gcount();
+		buffer[size] = '\0';
+
+		const char* p = buffer.data();
+		const char* end = buffer.data()+size;
+		while(p < end){
+			const char* eol = static_cast<const char*>(std::memchr(p, '\n', end-p));
+			if(!eol){
+				if(!last) break;					//Line continues in the next chunk
+				eol = end;							//Last line of the file has no newline
+			}
+			if(!fn(p, eol, bufferOffset+(p-buffer.data()))) return false;
+			p = eol+1;
+		}
+
+		//Move the unfinished line to the front of the buffer
+		kept = p < end ? end-p : 0;
+		std::memmove(buffer.data(), p, kept);
+		bufferOffset += size-kept;
+	}
+
+	return true;
+}
+
+//Skip spaces, tabs and carriage returns
+static const char* skipBlank(const char* p, const char* end){
+	while(p < end && (*p==' ' || *p=='\t' || *p=='\r')) p++;
+	return p;
+}
+
+//Constructor, nothing is read until loadVertices() is called
+ModelStream::ModelStream(const char* filename, const std::size_t chunkSize) :
+			filename_(filename), chunkSize_(chunkSize ? chunkSize : 1), vertices_(), faceStart_(-1), faceStartVerts_(0), bboxMin_(), bboxMax_() {}
+
+//First pass, read every vertex position of the file
+bool ModelStream::loadVertices(){
+	vertices_.clear();
+	faceStart_ = -1;
+
+	bool ok = forEachLine(filename_, 0, chunkSize_, [this](const char* p, const char* end, std::streamoff offset){
+		if(end-p < 2 || p[1]!=' ') return true;
+
+		if(p[0]=='v'){								//Is it a vertex?
+			Vec3f v;
+			float* xyz[3] = {&v.x, &v.y, &v.z};
+			p += 2;
+			for(int i=0; i<3; i++){
+				if((p = skipBlank(p, end)) >= end) break;
+				char* next;
+				*xyz[i] = std::strtof(p, &next);
+				p = next;
+			}
+			vertices_.push_back(v);
+		}else if(p[0]=='f' && faceStart_ < 0){		//Remember where the faces start
+			faceStart_ = offset;
+			faceStartVerts_ = vertices_.size();
+		}
+		return true;
+	});
+
+	bounds(vertices_, bboxMin_, bboxMax_);
+	return ok;
+}
+
+//Second pass, parse the faces and push them to the queue in batches of batchSize faces
+//The queue is closed when the file is done so the consumer knows to stop
+bool ModelStream::streamFaces(BoundedQueue<FaceBatch>& queue, const int batchSize) const{
+	if(faceStart_ < 0){
+		queue.close();
+		return true;
+	}
+
+	FaceBatch batch;
+	int nSeen = faceStartVerts_;					//Vertices defined so far, used by relative (negative) indices
+
+	bool ok = forEachLine(filename_, faceStart_, chunkSize_, [&](const char* p, const char* end, std::streamoff){
+		if(end-p < 2 || p[1]!=' ') return true;
+		if(p[0]=='v'){
+			nSeen++;
+			return true;
+		}
+		if(p[0]!='f') return true;
+
+		//Format "vertexIdx/vertexTextureIdx/vertexNormalIdx ..." where only the vertex index is needed
+		int n = 0;
+		bool valid = true;
+		p += 2;
+		while((p = skipBlank(p, end)) < end){
+			char* next;
+			long idx = std::strtol(p, &next, 10);
+			if(next == p || idx == 0) break;			//0 isn't an index, the face stops there like in the Model parser
+			idx = idx > 0 ? idx-1 : nSeen+idx;		//Wavefront obj indexing starts at 1, negative values count back from the last vertex
+			valid = valid && idx >= 0 && idx < nVerts();
+			batch.indices.push_back(idx);
+			n++;
+
+			p = next;
+			while(p < end && *p!=' ' && *p!='\t' && *p!='\r') p++;	//Trash the texture and normal indices
+		}
+
+		if(n < 3 || !valid){						//Drop faces that can't be drawn
+			batch.indices.resize(batch.indices.size()-n);
+			return true;
+		}
+		batch.sizes.push_back(n);
+
+		if(int(batch.sizes.size()) >= batchSize){
+			if(!queue.push(std::move(batch))) return false;	//Consumer stopped listening
+			batch = FaceBatch();
+		}
+		return true;
+	});
+
+	if(ok && !batch.sizes.empty()) queue.push(std::move(batch));
+	queue.close();
+	return ok;
+}
+
+//Get the vertex count
+int ModelStream::nVerts() const{
+	return vertices_.size();
+}
+
+//Get a vertex at index idx
+Vec3f ModelStream::vert(int idx) const{
+	return vertices_[idx];
+}
+
+//Get every vertex at once
+const std::vector<Vec3f>& ModelStream::verts() const{
+	return vertices_;
+}
+
+//Get the minimum corner of the bounding box
+Vec3f ModelStream::bboxMin() const{
+	return bboxMin_;
+}
+
+//Get the maximum corner of the bounding box
+Vec3f ModelStream::bboxMax() const{
+	return bboxMax_;
+}
\ No newline at end of file
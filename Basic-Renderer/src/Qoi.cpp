@@ -0,0 +1,290 @@
+#include "Qoi.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#define QOI_OP_INDEX 0x00					//00iiiiii: color at index i
+#define QOI_OP_DIFF 0x40					//01rrggbb: each channel differs from the previous pixel by -2..1
+#define QOI_OP_LUMA 0x80					//10gggggg rrrrbbbb: green differs by -32..31, red and blue by -8..7 more
+#define QOI_OP_RUN 0xC0						//11nnnnnn: previous pixel repeated n+1 times, 1..62
+#define QOI_OP_RGB 0xFE						//Literal color, alpha unchanged
+#define QOI_OP_RGBA 0xFF					//Literal color and alpha
+#define QOI_HEADER 14
+#define QOI_PADDING 8						//The stream ends with 7 zero bytes and a 1
+#define QOI_BUFFER (1 << 20)				//Encoded bytes collected before a write
+
+static const std::uint8_t padding[QOI_PADDING] = {0, 0, 0, 0, 0, 0, 0, 1};
+
+//Pack a color as r | g<<8 | b<<16 | a<<24
+static inline std::uint32_t pack(const std::uint8_t r, const std::uint8_t g, const std::uint8_t b, const std::uint8_t a){
+	return std::uint32_t(r) | std::uint32_t(g) << 8 | std::uint32_t(b) << 16 | std::uint32_t(a) << 24;
+}
+
+//Slot of a packed color in the index
+static inline int hash(const std::uint32_t px){
+	return ((px & 0xFF)*3 + (px >> 8 & 0xFF)*5 + (px >> 16 & 0xFF)*7 + (px >> 24)*11) & 63;
+}
+
+static inline void putBigEndian(std::uint8_t* p, const std::uint32_t v){
+	p[0] = v >> 24;
+	p[1] = v >> 16;
+	p[2] = v >> 8;
+	p[3] = v;
+}
+
+static inline std::uint32_t getBigEndian(const std::uint8_t* p){
+	return std::uint32_t(p[0]) << 24 | std::uint32_t(p[1]) << 16 | std::uint32_t(p[2]) << 8 | p[3];
+}
+
+//Closed encoder
+QoiEncoder::QoiEncoder() : out_(), buffer_(), used_(0), index_(), previous_(0), run_(0), width_(0), height_(0), rows_(0) {}
+
+//Finishes the file if close() wasn't called
+QoiEncoder::~QoiEncoder(){
+	if(out_.is_open()) close();
+}
+
+//Start a width x height file, channels 3 or 4 is what readers are told the pixels hold (alpha is kept either way)
+bool QoiEncoder::open(const std::string& filename, const int width, const int height, const int channels){
+	if(width <= 0 || height <= 0 || (channels != 3 && channels != 4)){
+		std::cerr << "Can't encode a " << width << "x" << height << " image with " << channels << " channels as QOI\n";
+		return false;
+	}
+	out_.open(filename, std::ios::binary);
+	if(!out_.is_open()){
+		std::cerr << "cant open file " << filename << " for writing\n";
+		return false;
+	}
+	width_ = width;
+	height_ = height;
+	rows_ = 0;
+	run_ = 0;
+	previous_ = pack(0, 0, 0, 255);
+	std::fill(index_, index_+64, 0);
+
+	//A row codes to at most 5 bytes a pixel and leaves at most one run pending, besides the header or the end
+	buffer_.resize(std::max<size_t>(QOI_BUFFER, size_t(width)*5 + QOI_HEADER + QOI_PADDING + 1));
+	std::uint8_t* p = buffer_.data();
+	memcpy(p, "qoif", 4);
+	putBigEndian(p+4, width);
+	putBigEndian(p+8, height);
+	p[12] = channels;
+	p[13] = 0;								//sRGB with linear alpha
+	used_ = QOI_HEADER;
+	return true;
+}
+
+//Write out the encoded bytes collected so far
+bool QoiEncoder::flush(){
+	out_.write(reinterpret_cast<const char*>(buffer_.data()), used_);
+	used_ = 0;
+	if(!out_.good()){
+		std::cerr << "Failed to write QOI data\n";
+		return false;
+	}
+	return true;
+}
+
+//Color of a pixel in TGA order (gray, BGR or BGRA), packed
+template<int Bpp>
+static inline std::uint32_t readPixel(const std::uint8_t* src){
+	switch(Bpp){
+		case 4: return pack(src[2], src[1], src[0], src[3]);
+		case 3: return pack(src[2], src[1], src[0], 255);
+		default: return pack(src[0], src[0], src[0], 255);
+	}
+}
+
+//Code width pixels step bytes apart to out, returns the end of the codes
+//previous, run and index carry the coder state from one row to the next
+template<int Bpp>
+static std::uint8_t* encodeRow(const std::uint8_t* src, const std::ptrdiff_t step, const int width, std::uint32_t* index,
+								std::uint32_t& previous, int& run, std::uint8_t* out){
+	for(int x=0; x<width; x++, src+=step){
+		const std::uint32_t px = readPixel<Bpp>(src);
+
+		if(px == previous){
+			//Backgrounds make long runs, take the whole run before coding it
+			int n = 1;
+			while(x+n < width && readPixel<Bpp>(src+n*step) == px) n++;
+			run += n;
+			x += n-1;
+			src += (n-1)*step;
+			for(; run >= 62; run -= 62) *out++ = QOI_OP_RUN | 61;
+			continue;
+		}
+		if(run){
+			*out++ = QOI_OP_RUN | (run-1);
+			run = 0;
+		}
+
+		const int h = hash(px);
+		if(index[h] == px){
+			*out++ = QOI_OP_INDEX | h;
+		}else{
+			index[h] = px;
+			if((px ^ previous) >> 24){
+				*out++ = QOI_OP_RGBA;
+				*out++ = px;
+				*out++ = px >> 8;
+				*out++ = px >> 16;
+				*out++ = px >> 24;
+			}else{
+				//Channel differences wrap around like the decoder's byte arithmetic
+				const int dr = std::int8_t(std::uint8_t(px) - std::uint8_t(previous));
+				const int dg = std::int8_t(std::uint8_t(px >> 8) - std::uint8_t(previous >> 8));
+				const int db = std::int8_t(std::uint8_t(px >> 16) - std::uint8_t(previous >> 16));
+				const int drg = dr-dg, dbg = db-dg;
+				if(dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1){
+					*out++ = QOI_OP_DIFF | (dr+2) << 4 | (dg+2) << 2 | (db+2);
+				}else if(dg >= -32 && dg <= 31 && drg >= -8 && drg <= 7 && dbg >= -8 && dbg <= 7){
+					*out++ = QOI_OP_LUMA | (dg+32);
+					*out++ = (drg+8) << 4 | (dbg+8);
+				}else{
+					*out++ = QOI_OP_RGB;
+					*out++ = px;
+					*out++ = px >> 8;
+					*out++ = px >> 16;
+				}
+			}
+		}
+		previous = px;
+	}
+	return out;
+}
+
+//Encode the next row from the top: width pixels of bpp bytes in TGA order (gray, BGR or BGRA)
+//reversed takes the pixels from the last one, for images whose data starts at the right
+bool QoiEncoder::writeRow(const std::uint8_t* row, const int bpp, const bool reversed){
+	if(!out_.is_open() || rows_ >= height_) return false;
+	if(used_ + size_t(width_)*5 + QOI_PADDING + 1 > buffer_.size() && !flush()) return false;
+
+	const std::ptrdiff_t step = reversed ? -bpp : bpp;
+	const std::uint8_t* src = reversed ? row + size_t(width_-1)*bpp : row;
+	std::uint8_t* out = buffer_.data() + used_;
+	switch(bpp){
+		case 4: out = encodeRow<4>(src, step, width_, index_, previous_, run_, out); break;
+		case 3: out = encodeRow<3>(src, step, width_, index_, previous_, run_, out); break;
+		default: out = encodeRow<1>(src, step, width_, index_, previous_, run_, out);
+	}
+	used_ = out - buffer_.data();
+	rows_++;
+	return true;
+}
+
+//End the stream and close the file, fails if rows are missing
+bool QoiEncoder::close(){
+	if(!out_.is_open()) return false;
+	bool ok = rows_ == height_;
+	if(!ok) std::cerr << "QOI file closed after " << rows_ << " of " << height_ << " rows\n";
+	if(run_) buffer_[used_++] = QOI_OP_RUN | (run_-1);
+	run_ = 0;
+	memcpy(buffer_.data()+used_, padding, QOI_PADDING);
+	used_ += QOI_PADDING;
+	ok = flush() && ok;
+	out_.close();
+	return ok;
+}
+
+//Decode count pixels of C bytes in TGA order (BGR or BGRA) to dst from a QOI stream of size bytes, header included
+//Fails if the codes end before the last pixel
+template<int C>
+static bool decodePixels(const std::uint8_t* in, const size_t size, const size_t count, std::uint8_t* dst){
+	std::uint32_t index[64] = {};
+	std::uint8_t r = 0, g = 0, b = 0, a = 255;
+	const size_t end = size-QOI_PADDING;		//Pixel data stops at the padding
+	size_t p = QOI_HEADER;
+	std::uint8_t* const last = dst + count*C;
+
+	while(dst < last){
+		if(p >= end) return false;
+		const std::uint8_t op = in[p++];
+		if(op == QOI_OP_RGB){
+			if(p+3 > end) return false;
+			r = in[p];
+			g = in[p+1];
+			b = in[p+2];
+			p += 3;
+		}else if(op == QOI_OP_RGBA){
+			if(p+4 > end) return false;
+			r = in[p];
+			g = in[p+1];
+			b = in[p+2];
+			a = in[p+3];
+			p += 4;
+		}else switch(op & 0xC0){
+			case QOI_OP_INDEX:{
+				const std::uint32_t px = index[op];
+				r = px;
+				g = px >> 8;
+				b = px >> 16;
+				a = px >> 24;
+				break;
+			}
+			case QOI_OP_DIFF:
+				r += ((op >> 4) & 3) - 2;
+				g += ((op >> 2) & 3) - 2;
+				b += (op & 3) - 2;
+				break;
+			case QOI_OP_LUMA:{
+				if(p >= end) return false;
+				const int dg = (op & 0x3F) - 32;
+				const std::uint8_t rb = in[p++];
+				r += dg + (rb >> 4) - 8;
+				g += dg;
+				b += dg + (rb & 0x0F) - 8;
+				break;
+			}
+			default:{							//Run: the previous pixel again, it is already in the index
+				const size_t n = std::min<size_t>((op & 0x3F) + 1, (last-dst)/C);
+				for(size_t i=0; i<n; i++, dst+=C){
+					dst[0] = b;
+					dst[1] = g;
+					dst[2] = r;
+					if(C == 4) dst[3] = a;
+				}
+				continue;
+			}
+		}
+		const std::uint32_t px = pack(r, g, b, a);
+		index[hash(px)] = px;
+		dst[0] = b;
+		dst[1] = g;
+		dst[2] = r;
+		if(C == 4) dst[3] = a;
+		dst += C;
+	}
+	return true;
+}
+
+//Decode a whole QOI file held in memory, gives its size, channels (3 or 4) and pixels from the top left in TGA order
+bool qoiDecode(const std::uint8_t* in, const size_t size, int& width, int& height, int& channels, std::vector<std::uint8_t>& pixels){
+	if(size < QOI_HEADER+QOI_PADDING || memcmp(in, "qoif", 4)){
+		std::cerr << "Not a QOI file\n";
+		return false;
+	}
+	const std::uint32_t w = getBigEndian(in+4), h = getBigEndian(in+8);
+	const int c = in[12];
+	if(!w || !h || w > 0x7FFFFFFF || h > 0x7FFFFFFF || (c != 3 && c != 4)){
+		std::cerr << "Bad QOI header: " << w << "x" << h << " with " << c << " channels\n";
+		return false;
+	}
+	//Every code makes at least one pixel and a run at most 62: larger sizes can't come from this stream
+	const size_t count = size_t(w)*h;
+	if(count/62 > size){
+		std::cerr << "QOI file too short for " << w << "x" << h << " pixels\n";
+		return false;
+	}
+
+	pixels.resize(count*c);
+	const bool ok = c == 4 ? decodePixels<4>(in, size, count, pixels.data()) : decodePixels<3>(in, size, count, pixels.data());
+	if(!ok){
+		std::cerr << "QOI data ends before the last pixel\n";
+		return false;
+	}
+	width = w;
+	height = h;
+	channels = c;
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,209 @@
+#include "Resample.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+//Filter weights along one axis, output i blends count[i] source pixels from first[i] with the weights at i*taps
+struct Kernel {
+	int taps;									//Largest count, the stride of weights
+	std::vector<int> first, count;
+	std::vector<float> weights;
+};
+
+//Radius of a filter in source pixels when it isn't stretched
+static float radius(const TGAImage::Filter filter){
+	switch(filter){
+		case TGAImage::BOX: return 0.5f;
+		case TGAImage::LANCZOS3: return 3;
+		default: return 1;
+	}
+}
+
+//Weight of a source pixel at distance x from the sample
+static float weight(const TGAImage::Filter filter, float x){
+	x = std::fabs(x);
+	switch(filter){
+		case TGAImage::BOX:
+			return x <= 0.5f ? 1 : 0;
+		case TGAImage::LANCZOS3:{
+			if(x >= 3) return 0;
+			if(x < 1e-6f) return 1;
+			const float pix = float(M_PI)*x;
+			return 3*std::sin(pix)*std::sin(pix/3)/(pix*pix);
+		}
+		default:
+			return x < 1 ? 1-x : 0;
+	}
+}
+
+//Weights resampling src pixels to dst, the filter is stretched over the source pixels an output pixel covers when
+//shrinking so none is skipped. Pixels past the edges are left out and the rest renormalized
+static Kernel kernel(const int src, const int dst, const TGAImage::Filter filter){
+	Kernel k;
+	const float ratio = float(src)/dst;
+	const float scale = std::max(1.f, ratio);
+	const float support = radius(filter)*scale;
+	k.taps = std::min(src, int(std::ceil(2*support))+1);
+	k.first.resize(dst);
+	k.count.resize(dst);
+	k.weights.assign(size_t(dst)*k.taps, 0);
+
+	for(int i=0; i<dst; i++){
+		const float center = (i+0.5f)*ratio;
+		int first = std::max(0, int(std::floor(center-support+0.5f)));
+		int last = std::min(src, int(std::floor(center+support+0.5f)));
+		last = std::min(last, first+k.taps);
+		float* w = &k.weights[size_t(i)*k.taps];
+		float total = 0;
+		for(int x=first; x<last; x++) total += w[x-first] = weight(filter, (x+0.5f-center)/scale);
+		if(total == 0){								//Only for degenerate windows: take the closest pixel
+			first = std::min(src-1, int(center));
+			last = first+1;
+			w[0] = total = 1;
+		}
+		for(int x=first; x<last; x++) w[x-first] /= total;
+		k.first[i] = first;
+		k.count[i] = last-first;
+	}
+	return k;
+}
+
+//Source row as 4 floats a pixel, gray and RGB leave the unused channels 0, RGBA is premultiplied by alpha so
+//transparent pixels don't bleed their color into their neighbours
+static void loadRow(const std::uint8_t* src, const int width, const int bpp, float* row){
+#if defined(__SSE2__)
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 colors = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+	for(int x=0; x<width; x++, src+=bpp, row+=4){
+		std::uint32_t bytes = 0;
+		memcpy(&bytes, src, bpp);
+		__m128 p = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero), zero));
+		if(bpp == TGAImage::RGBA){
+			const __m128 a = _mm_mul_ps(_mm_shuffle_ps(p, p, 0xFF), _mm_set1_ps(1/255.f));
+			p = _mm_or_ps(_mm_and_ps(colors, _mm_mul_ps(p, a)), _mm_andnot_ps(colors, p));
+		}
+		_mm_storeu_ps(row, p);
+	}
+#else
+	for(int x=0; x<width; x++, src+=bpp, row+=4){
+		row[0] = src[0];
+		row[1] = bpp > 1 ? src[1] : 0;
+		row[2] = bpp > 1 ? src[2] : 0;
+		row[3] = bpp > 3 ? src[3] : 0;
+		if(bpp == TGAImage::RGBA){
+			const float a = src[3]/255.f;
+			row[0] *= a;
+			row[1] *= a;
+			row[2] *= a;
+		}
+	}
+#endif
+}
+
+//Resample a row of 4 float pixels along x
+static void filterRow(const float* row, const Kernel& k, const int w, float* out){
+	for(int x=0; x<w; x++, out+=4){
+		const float* p = row + 4*k.first[x];
+		const float* wt = &k.weights[size_t(x)*k.taps];
+		const int n = k.count[x];
+#if defined(__SSE2__)
+		__m128 acc = _mm_setzero_ps();
+		for(int t=0; t<n; t++) acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(p+4*t), _mm_set1_ps(wt[t])));
+		_mm_storeu_ps(out, acc);
+#else
+		float acc[4] = {0, 0, 0, 0};
+		for(int t=0; t<n; t++)
+			for(int c=0; c<4; c++) acc[c] += p[4*t+c]*wt[t];
+		for(int c=0; c<4; c++) out[c] = acc[c];
+#endif
+	}
+}
+
+//Add a row of w 4 float pixels times weight to acc
+static void accumulate(float* acc, const float* row, const float weight, const int w){
+#if defined(__SSE2__)
+	const __m128 wt = _mm_set1_ps(weight);
+	for(int x=0; x<4*w; x+=4) _mm_storeu_ps(acc+x, _mm_add_ps(_mm_loadu_ps(acc+x), _mm_mul_ps(_mm_loadu_ps(row+x), wt)));
+#else
+	for(int x=0; x<4*w; x++) acc[x] += row[x]*weight;
+#endif
+}
+
+//Round a row of 4 float pixels back to bytes, undoing the premultiplication of RGBA
+static void storeRow(const float* row, const int w, const int bpp, std::uint8_t* dst){
+	for(int x=0; x<w; x++, row+=4, dst+=bpp){
+		float c[4] = {row[0], row[1], row[2], row[3]};
+		if(bpp == TGAImage::RGBA){
+			const float scale = c[3] > 0.5f/255 ? 255/c[3] : 0;	//Fully transparent pixels come out black
+			c[0] *= scale;
+			c[1] *= scale;
+			c[2] *= scale;
+		}
+		for(int t=0; t<bpp; t++) dst[t] = std::uint8_t(std::min(std::max(c[t], 0.f), 255.f) + 0.5f);
+	}
+}
+
+//Resample a width x height image with bpp bytes a pixel to w x h at dst, with a separable filter
+//Every thread makes a band of output rows: the source rows a band needs are filtered along x once, into a ring of the
+//last rows its vertical filter spans, and blended along y. Neither pass needs a copy of the whole image
+//NEAREST copies the source pixel under each output pixel's center
+void resample(const std::uint8_t* src, const int width, const int height, const int bpp, std::uint8_t* dst, const int w, const int h,
+				const TGAImage::Filter filter, const int nThreads){
+	if(width <= 0 || height <= 0 || w <= 0 || h <= 0) return;
+	const size_t srcPitch = size_t(width)*bpp, dstPitch = size_t(w)*bpp;
+	if(w == width && h == height){						//Every filter keeps the pixels as they are
+		memcpy(dst, src, dstPitch*h);
+		return;
+	}
+
+	if(filter == TGAImage::NEAREST){
+		std::vector<int> columns(w);
+		for(int x=0; x<w; x++) columns[x] = std::min(width-1, int((x+0.5)*width/w))*bpp;
+		for(int y=0; y<h; y++){
+			const std::uint8_t* row = src + std::min(height-1, int((y+0.5)*height/h))*srcPitch;
+			std::uint8_t* out = dst + y*dstPitch;
+			for(int x=0; x<w; x++)
+				for(int t=0; t<bpp; t++) out[x*bpp+t] = row[columns[x]+t];
+		}
+		return;
+	}
+
+	const Kernel kx = kernel(width, w, filter), ky = kernel(height, h, filter);
+	const int threads = nThreads > 0 ? nThreads : std::max(1u, std::thread::hardware_concurrency());
+	const int nBands = std::max(1, std::min(threads, h/16));
+
+	auto band = [&](const int b){
+		const int y0 = h*b/nBands, y1 = h*(b+1)/nBands;
+		std::vector<float> source(4*size_t(width));
+		std::vector<float> ring(4*size_t(w)*ky.taps);	//Source row r filtered along x is at slot r%taps
+		std::vector<int> slot(ky.taps, -1);				//Source row in each slot
+		std::vector<float> acc(4*size_t(w));
+
+		for(int y=y0; y<y1; y++){
+			std::fill(acc.begin(), acc.end(), 0.f);
+			for(int t=0; t<ky.count[y]; t++){
+				const int r = ky.first[y]+t;
+				float* filtered = &ring[4*size_t(w)*(r%ky.taps)];
+				if(slot[r%ky.taps] != r){
+					loadRow(src + r*srcPitch, width, bpp, source.data());
+					filterRow(source.data(), kx, w, filtered);
+					slot[r%ky.taps] = r;
+				}
+				accumulate(acc.data(), filtered, ky.weights[size_t(y)*ky.taps+t], w);
+			}
+			storeRow(acc.data(), w, bpp, dst + y*dstPitch);
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for(int b=1; b<nBands; b++) workers.emplace_back(band, b);
+	band(0);
+	for(std::thread& t : workers) t.join();
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "ShadowMap.h"
+#include "Camera.h"
+#include "Transform.h"
+#include "my_gl.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+//Empty map, everything is lit
+ShadowMap::ShadowMap() : size_(0), matrix_(Mat4f::identity()), depth_(), pitch_(0), bias_(0) {}
+
+//Render the depth of a model seen from light (direction from the model towards the light) into a size x size map
+//The light's orthographic view just fits the model's bounding sphere
+ShadowMap::ShadowMap(const Model* model, const Vec3f& light, const int size) : size_(size), matrix_(), depth_(), pitch_(paddedPitch(size)), bias_(0) {
+	Vec3f center = (model->bboxMin()+model->bboxMax())*0.5f;
+	float radius = std::max((model->bboxMax()-model->bboxMin()).length()*0.5f, 1e-6f);
+	Vec3f dir = light;
+	dir.normalize();
+
+	Camera cam(center + dir*(radius*2), center, std::fabs(dir.y) > 0.999f ? Vec3f(0,0,-1) : Vec3f(0,1,0), 0);
+	cam.height = radius*2;
+	cam.zNear = radius;
+	cam.zFar = radius*3;
+	matrix_ = cam.matrix(size, size);
+
+	//Depth spans 2 over the sphere's diameter and a texel is 1/size of it: allow for a slope of about 4 texels
+	bias_ = 8.f/size;
+
+	depth_.assign(pitch_*size, FLT_MAX);
+	RenderTarget target;
+	target.depth = depth_.data();
+	target.depthPitch = pitch_;
+	target.width = target.height = size;
+
+	VertexBuffer screen;
+	projectVertices(model->verts(), matrix_, size, size, screen);
+
+	Vec3f pts[3];
+	for(int i=0; i<model->nFaces(); i++){
+		std::vector<int> face = model->face(i);
+		pts[0] = Vec3f(screen.x[face[0]], screen.y[face[0]], screen.z[face[0]]);
+		for(int j=1; j+1<int(face.size()); j++){
+			pts[1] = Vec3f(screen.x[face[j]], screen.y[face[j]], screen.z[face[j]]);
+			pts[2] = Vec3f(screen.x[face[j+1]], screen.y[face[j+1]], screen.z[face[j+1]]);
+			depthTriangle(pts, target);
+		}
+	}
+}
+
+//Get the width and height of the map
+int ShadowMap::size() const{
+	return size_;
+}
+
+//Position of a model space point in the map: x,y in texels and the depth seen from the light
+//The light's view is orthographic, so this is affine and can be interpolated linearly across a face
+Vec3f ShadowMap::project(const Vec3f& p) const{
+	return toScreen(matrix_*Vec4f(p, 1), size_, size_);
+}
+
+//Fraction of a point's surroundings that is lit, x,y,z as given by project()
+//Compares against the (2*pcf+1)^2 texels around the point (percentage closer filtering), pcf 0 is a single hard lookup
+//Points outside the map are lit
+float ShadowMap::lit(const float x, const float y, const float z, const int pcf) const{
+	if(depth_.empty()) return 1;
+	const int cx = int(std::floor(x)), cy = int(std::floor(y));
+	const float reference = z-bias_;
+	int count = 0;
+	for(int ty=cy-pcf; ty<=cy+pcf; ty++)
+		for(int tx=cx-pcf; tx<=cx+pcf; tx++)
+			if(tx < 0 || ty < 0 || tx >= size_ || ty >= size_ || reference <= depth_[ty*pitch_+tx]) count++;
+	return float(count)/((2*pcf+1)*(2*pcf+1));
+}
\ No newline at end of file
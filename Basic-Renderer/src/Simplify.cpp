@@ -0,0 +1,306 @@
+#include "Simplify.h"
+#include "EdgeList.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+
+#define BOUNDARY_WEIGHT 1000.	//Weight of the planes that keep open borders from shrinking
+
+//Symmetric 4x4 matrix holding the sum of squared distances to a set of planes
+//Only the upper triangle is stored: a2 ab ac ad b2 bc bd c2 cd d2
+struct Quadric {
+	double q[10] = {0,0,0,0,0,0,0,0,0,0};
+
+	Quadric() = default;
+
+	//Quadric of the plane ax+by+cz+d=0 scaled by weight w
+	Quadric(const double a, const double b, const double c, const double d, const double w)
+		:q{w*a*a, w*a*b, w*a*c, w*a*d, w*b*b, w*b*c, w*b*d, w*c*c, w*c*d, w*d*d} {}
+
+	Quadric& operator+=(const Quadric& o){
+		for(int i=0; i<10; i++) q[i] += o.q[i];
+		return *this;
+	}
+
+	//Sum of the squared distances from v to the planes
+	double error(const Vec3f& v) const{
+		double x = v.x, y = v.y, z = v.z;
+		return q[0]*x*x + 2*q[1]*x*y + 2*q[2]*x*z + 2*q[3]*x
+			+ q[4]*y*y + 2*q[5]*y*z + 2*q[6]*y
+			+ q[7]*z*z + 2*q[8]*z + q[9];
+	}
+
+	//Point with the smallest error, found by solving the 3x3 system with Cramer's rule
+	//Returns false if the system is close to singular (flat or straight neighbourhoods)
+	bool optimum(Vec3f& v) const{
+		double c00 = q[4]*q[7]-q[5]*q[5];
+		double c01 = q[2]*q[5]-q[1]*q[7];
+		double c02 = q[1]*q[5]-q[2]*q[4];
+		double det = q[0]*c00 + q[1]*c01 + q[2]*c02;
+		double scale = q[0]+q[4]+q[7];
+		if(std::fabs(det) <= 1e-9*scale*scale*scale) return false;
+
+		double c11 = q[0]*q[7]-q[2]*q[2];
+		double c12 = q[1]*q[2]-q[0]*q[5];
+		double c22 = q[0]*q[4]-q[1]*q[1];
+		double bx = -q[3], by = -q[6], bz = -q[8];
+		v = Vec3f((c00*bx + c01*by + c02*bz)/det, (c01*bx + c11*by + c12*bz)/det, (c02*bx + c12*by + c22*bz)/det);
+		return true;
+	}
+};
+
+//Candidate edge collapse, v1 is merged into v0 at target
+struct Collapse {
+	double cost;
+	int v0, v1;
+	int stamp0, stamp1;				//Vertex stamps at the time the cost was computed, a mismatch means the entry is stale
+	Vec3f target;
+
+	bool operator>(const Collapse& o) const { return cost > o.cost; }
+};
+
+//Triangle of the working mesh
+struct Tri {
+	int v[3];
+
+	bool has(const int i) const { return v[0]==i || v[1]==i || v[2]==i; }
+};
+
+//Unnormalized triangle normal with one vertex moved
+static Vec3f triNormal(const Tri& t, const std::vector<Vec3f>& pos, const int moved, const Vec3f& to){
+	Vec3f p[3];
+	for(int k=0; k<3; k++) p[k] = t.v[k]==moved ? to : pos[t.v[k]];
+	return (p[1]-p[0]).cross(p[2]-p[0]);
+}
+
+
+Model simplify(const Model* model, const int targetFaces){
+
+	const int nVerts = model->nVerts();
+	std::vector<Vec3f> pos(nVerts);
+	for(int i=0; i<nVerts; i++) pos[i] = model->vert(i);
+
+	//Fan triangulate every polygon
+	std::vector<Tri> tris;
+	tris.reserve(model->nFaces()*2);
+	for(int i=0; i<model->nFaces(); i++){
+		std::vector<int> face = model->face(i);
+		for(size_t j=2; j<face.size(); j++){
+			Tri t = {{face[0], face[j-1], face[j]}};
+			if(t.v[0]!=t.v[1] && t.v[1]!=t.v[2] && t.v[0]!=t.v[2]) tris.push_back(t);
+		}
+	}
+
+	std::vector<std::vector<int>> vertTris(nVerts);		//Triangles using each vertex
+	std::vector<Quadric> quadrics(nVerts);
+	std::vector<bool> triDead(tris.size(), false);
+	std::vector<bool> vertDead(nVerts, false);
+	std::vector<int> stamp(nVerts, 0);
+
+	//Every vertex starts with the planes of its triangles, weighted by area so slivers count less
+	for(size_t i=0; i<tris.size(); i++){
+		Vec3f n = triNormal(tris[i], pos, -1, Vec3f());
+		double area2 = n.length();
+		for(int k=0; k<3; k++) vertTris[tris[i].v[k]].push_back(i);
+		if(area2 <= 0) continue;
+
+		n = n*float(1/area2);
+		Quadric plane(n.x, n.y, n.z, -n.dot(pos[tris[i].v[0]]), area2/2);
+		for(int k=0; k<3; k++) quadrics[tris[i].v[k]] += plane;
+	}
+
+	//Borders get an extra plane through the edge, perpendicular to its face, so they don't get eaten away
+	EdgeList edges(model);
+	for(int i=0; i<edges.nEdges(); i++){
+		const Edge& e = edges.edge(i);
+		if(e.f1 >= 0) continue;
+		Vec3f dir = pos[e.v1]-pos[e.v0];
+		Vec3f n = dir.cross(edges.faceNormal(e.f0)).normalize();
+		Quadric border(n.x, n.y, n.z, -n.dot(pos[e.v0]), BOUNDARY_WEIGHT*dir.length2());
+		quadrics[e.v0] += border;
+		quadrics[e.v1] += border;
+	}
+
+	//Cheapest position to merge two vertices, falls back to the end points or midpoint when there's no unique optimum
+	auto evaluate = [&](const int a, const int b){
+		Quadric q = quadrics[a];
+		q += quadrics[b];
+
+		Collapse c = {0, a, b, stamp[a], stamp[b], Vec3f()};
+		Vec3f mid = (pos[a]+pos[b])*0.5f;
+		Vec3f candidates[4] = {pos[a], pos[b], mid, mid};
+		int nCandidates = 3;
+		if(q.optimum(candidates[3]) && (candidates[3]-mid).length2() <= 4*(pos[a]-pos[b]).length2()) nCandidates = 4;
+
+		c.cost = -1;
+		for(int k=0; k<nCandidates; k++){
+			double err = q.error(candidates[k]);
+			if(c.cost < 0 || err < c.cost){
+				c.cost = err;
+				c.target = candidates[k];
+			}
+		}
+		return c;
+	};
+
+	std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> heap;
+	for(const Tri& t : tris){
+		for(int k=0; k<3; k++){
+			int a = t.v[k], b = t.v[(k+1)%3];
+			heap.push(evaluate(std::min(a, b), std::max(a, b)));	//Shared edges are pushed twice, the copy is dropped once the edge is gone
+		}
+	}
+
+	std::vector<int> mark(nVerts, -1);
+	int generation = 0;
+	int alive = tris.size();
+
+	while(alive > targetFaces && !heap.empty()){
+		Collapse c = heap.top();
+		heap.pop();
+		const int a = c.v0, b = c.v1;
+		if(vertDead[a] || vertDead[b] || stamp[a]!=c.stamp0 || stamp[b]!=c.stamp1) continue;
+
+		//Link condition: the only common neighbours of a and b must be the opposite corners of the triangles on the edge
+		//otherwise the collapse pinches the surface into a non-manifold shape
+		generation++;
+		for(int t : vertTris[a]){
+			if(triDead[t]) continue;
+			for(int k=0; k<3; k++) mark[tris[t].v[k]] = generation;
+		}
+		int shared = 0;
+		for(int t : vertTris[b]){
+			if(triDead[t] || !tris[t].has(a)) continue;
+			shared++;
+			for(int k=0; k<3; k++) if(tris[t].v[k]!=a && tris[t].v[k]!=b) mark[tris[t].v[k]] = -1;	//Opposite corner is allowed
+		}
+		if(shared == 0) continue;
+
+		bool pinches = false;
+		for(int t : vertTris[b]){
+			if(triDead[t] || tris[t].has(a)) continue;
+			for(int k=0; k<3; k++) pinches = pinches || (tris[t].v[k]!=b && mark[tris[t].v[k]]==generation);
+		}
+		if(pinches) continue;
+
+		//Reject collapses that would fold a triangle over
+		bool flips = false;
+		for(int v : {a, b}){
+			for(int t : vertTris[v]){
+				if(flips) break;
+				if(triDead[t] || (tris[t].has(a) && tris[t].has(b))) continue;
+				Vec3f before = triNormal(tris[t], pos, -1, Vec3f());
+				Vec3f after = triNormal(tris[t], pos, v, c.target);
+				flips = before.dot(after) <= 0;
+			}
+		}
+		if(flips) continue;
+
+		//Merge b into a
+		pos[a] = c.target;
+		quadrics[a] += quadrics[b];
+		vertDead[b] = true;
+		stamp[a]++;
+
+		for(int t : vertTris[b]){
+			if(triDead[t]) continue;
+			if(tris[t].has(a)){
+				triDead[t] = true;					//Triangles on the collapsed edge disappear
+				alive--;
+				continue;
+			}
+			for(int k=0; k<3; k++) if(tris[t].v[k]==b) tris[t].v[k] = a;
+			vertTris[a].push_back(t);
+		}
+		vertTris[b].clear();
+		vertTris[a].erase(std::remove_if(vertTris[a].begin(), vertTris[a].end(), [&](int t){ return triDead[t]; }), vertTris[a].end());
+
+		//Every edge around a changed cost
+		generation++;
+		for(int t : vertTris[a]){
+			for(int k=0; k<3; k++){
+				int w = tris[t].v[k];
+				if(w==a || mark[w]==generation) continue;
+				mark[w] = generation;
+				heap.push(evaluate(a, w));
+			}
+		}
+	}
+
+	//Compact the surviving vertices and triangles into a new model
+	std::vector<int> remap(nVerts, -1);
+	std::vector<Vec3f> vertices;
+	std::vector<std::vector<int>> faces;
+	faces.reserve(alive);
+	for(size_t i=0; i<tris.size(); i++){
+		if(triDead[i]) continue;
+		std::vector<int> f(3);
+		for(int k=0; k<3; k++){
+			int v = tris[i].v[k];
+			if(remap[v] < 0){
+				remap[v] = vertices.size();
+				vertices.push_back(pos[v]);
+			}
+			f[k] = remap[v];
+		}
+		faces.push_back(f);
+	}
+
+	return Model(vertices, faces);
+}
+
+
+//Build the chain, one level per face count target that is below the previous level
+//Targets under minFaces are skipped: select() never picks a level below the faces it wants (see wantedFaces),
+//so a chain built for one view only simplifies as far as that view needs, and not at all when it wants every face
+LODChain::LODChain(const Model* model, const std::vector<int>& targets, const float minFaces) : base_(model), levels_() {
+
+	std::vector<int> sorted(targets);
+	std::sort(sorted.begin(), sorted.end(), std::greater<int>());
+
+	levels_.reserve(sorted.size());							//Levels point at each other while being built, so no reallocation
+	const Model* previous = model;
+	for(int target : sorted){
+		if(target <= 0 || target < minFaces || target >= previous->nFaces()) continue;
+		levels_.push_back(simplify(previous, target));		//Simplifying the previous level is much faster than starting over
+		previous = &levels_.back();
+	}
+}
+
+//Face count targets dividing the face count by 4 at every level, down to minFaces
+std::vector<int> LODChain::defaultTargets(const Model* model, const int minFaces){
+	std::vector<int> targets;
+	for(int target=model->nFaces()/4; target >= minFaces; target /= 4)
+		targets.push_back(target);
+	return targets;
+}
+
+//Get the number of levels, including the base model
+int LODChain::nLevels() const{
+	return levels_.size()+1;
+}
+
+//Get the model of a level, 0 is the full detail model
+const Model* LODChain::level(int idx) const{
+	return idx ? &levels_[idx-1] : base_;
+}
+
+//Number of faces a model needs to keep one face per pixelsPerFace covered pixels
+//The covered area is the bounding box of the model mapped by view and clipped to a width x height image
+float LODChain::wantedFaces(const Model* model, const Viewport& view, const int width, const int height, const float pixelsPerFace){
+	Vec3f a = view.apply(model->bboxMin());
+	Vec3f b = view.apply(model->bboxMax());
+	float x0 = std::max(0.f, std::min(a.x, b.x)), x1 = std::min(float(width), std::max(a.x, b.x));
+	float y0 = std::max(0.f, std::min(a.y, b.y)), y1 = std::min(float(height), std::max(a.y, b.y));
+	return std::max(0.f, x1-x0)*std::max(0.f, y1-y0)/pixelsPerFace;
+}
+
+//Pick the coarsest level that still has the faces wantedFaces asks for
+const Model* LODChain::select(const Viewport& view, const int width, const int height, const float pixelsPerFace) const{
+	const float wanted = wantedFaces(base_, view, width, height, pixelsPerFace);
+	for(int i=nLevels()-1; i>0; i--)
+		if(level(i)->nFaces() >= wanted) return level(i);
+	return base_;
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "StripeWriter.h"
+#include "TGAImage.h"
+
+#include <cstring>
+#include <iostream>
+
+//Whether a file name ends with ext
+static bool endsWith(const std::string& name, const char* ext){
+	const size_t n = strlen(ext);
+	return name.size() > n && name.compare(name.size()-n, n, ext) == 0;
+}
+
+//Closed writer
+StripeWriter::StripeWriter() : format_(AUTO), out_(), qoi_(), converted_(), width_(0), height_(0), bpp_(0), rows_(0), open_(false) {}
+
+//Finishes the file if close() wasn't called
+StripeWriter::~StripeWriter(){
+	if(open_) close();
+}
+
+//Start a width x height file of bpp bytes per pixel (gray, BGR or BGRA as in TGAImage), the header goes out at once
+bool StripeWriter::open(const std::string& filename, const int width, const int height, const int bpp, const Format format){
+	if(width <= 0 || height <= 0 || (bpp != TGAImage::GRAYSCALE && bpp != TGAImage::RGB && bpp != TGAImage::RGBA)){
+		std::cerr << "Can't write a " << width << "x" << height << " image with " << bpp << " bytes per pixel\n";
+		return false;
+	}
+	format_ = format != AUTO ? format : endsWith(filename, ".qoi") ? QOI : endsWith(filename, ".ppm") ? PPM : TGA;
+	width_ = width;
+	height_ = height;
+	bpp_ = bpp;
+	rows_ = 0;
+
+	if(format_ == QOI){
+		open_ = qoi_.open(filename, width, height, bpp == TGAImage::RGBA ? 4 : 3);
+		return open_;
+	}
+	if(format_ == TGA && (width > 0xFFFF || height > 0xFFFF)){
+		std::cerr << width << "x" << height << " is too large for TGA, write .ppm or .qoi instead\n";
+		return false;
+	}
+
+	out_.open(filename, std::ios::binary);
+	if(!out_.is_open()){
+		std::cerr << "cant open file " << filename << " for writing\n";
+		return false;
+	}
+	if(format_ == PPM){
+		out_ << (bpp == TGAImage::GRAYSCALE ? "P5\n" : "P6\n") << width << " " << height << "\n255\n";
+	}else{
+		TGA_Header header;
+		header.bitsperpixel = bpp << 3;
+		header.width = width;
+		header.height = height;
+		header.datatypecode = bpp == TGAImage::GRAYSCALE ? 3 : 2;
+		header.imagedescriptor = TGAImage::TOP_LEFT;			//Rows come from the top
+		out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	}
+	open_ = out_.good();
+	if(!open_) std::cerr << "Failed to write the header of " << filename << "\n";
+	return open_;
+}
+
+//Write the next n rows, pitch bytes apart from rows (negative to take them from the bottom up)
+bool StripeWriter::write(const std::uint8_t* rows, const int n, const std::ptrdiff_t pitch){
+	if(!open_ || n < 0 || rows_+n > height_) return false;
+	const size_t rowBytes = size_t(width_)*bpp_;
+
+	if(format_ == QOI){
+		for(int y=0; y<n; y++)
+			if(!qoi_.writeRow(rows + y*pitch, bpp_)) return false;
+	}else if(format_ == TGA || bpp_ == TGAImage::GRAYSCALE){
+		if(pitch == std::ptrdiff_t(rowBytes)){
+			out_.write(reinterpret_cast<const char*>(rows), rowBytes*n);
+		}else{
+			for(int y=0; y<n; y++) out_.write(reinterpret_cast<const char*>(rows + y*pitch), rowBytes);
+		}
+	}else{
+		//PPM wants RGB: swap red and blue and drop alpha, a stripe at a time
+		converted_.resize(size_t(width_)*3*n);
+		std::uint8_t* dst = converted_.data();
+		for(int y=0; y<n; y++){
+			const std::uint8_t* src = rows + y*pitch;
+			for(int x=0; x<width_; x++, src+=bpp_, dst+=3){
+				dst[0] = src[2];
+				dst[1] = src[1];
+				dst[2] = src[0];
+			}
+		}
+		out_.write(reinterpret_cast<const char*>(converted_.data()), converted_.size());
+	}
+	rows_ += n;
+	if(format_ != QOI && !out_.good()){
+		std::cerr << "Failed to write image rows\n";
+		return false;
+	}
+	return true;
+}
+
+//End the file, fails if rows are missing
+bool StripeWriter::close(){
+	if(!open_) return false;
+	open_ = false;
+	if(format_ == QOI) return qoi_.close();
+
+	bool ok = rows_ == height_;
+	if(!ok) std::cerr << "Image closed after " << rows_ << " of " << height_ << " rows\n";
+	if(format_ == TGA){
+		const std::uint8_t areas[8] = {0};				//No developer or extension area
+		const std::uint8_t footer[18] = {'T','R','U','E','V','I','S','I','O','N','-','X','F','I','L','E','.','\0'};
+		out_.write(reinterpret_cast<const char*>(areas), sizeof(areas));
+		out_.write(reinterpret_cast<const char*>(footer), sizeof(footer));
+	}
+	ok = out_.good() && ok;
+	out_.close();
+	return ok;
+}
\ No newline at end of file
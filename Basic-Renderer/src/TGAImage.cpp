@@ -1,470 +1,784 @@
-#include <algorithm>
-#include <iostream>
-#include <cstring>
-
-
-#include "TGAImage.h"
-
-//Default constructor
-TGAImage::TGAImage(): data(), width(0), height(0), bytesPerPixel(0){}
-
-//Constructor by value
-TGAImage::TGAImage(const int _width, const int _height, const int _bpp) :
-				data(_width*_height*_bpp, 0), width(_width), height(_height), bytesPerPixel(_bpp) {}
-
-
-//Read in a TGA file
-bool TGAImage::read_tga_file(const std::string filename){
-
-	std::ifstream in;
-	in.open(filename, std::ios::binary);
-	if(!in.is_open()){
-		std::cerr << "Can't open file " << filename << "\n";
-		in.close();
-		return false;
-	}
-
-	//Retrieve the TGA header
-	TGA_Header header;
-	//Bytes are packed sequentially so read sizeof(header) bytes into the casted char pointer
-	in.read(reinterpret_cast<char *>(&header), sizeof(header));
-	if(!in.good()){
-		std::cerr << "An error occured while reading the header\n";
-		in.close();
-		return false;
-	}
-
-	//read values from the header
-	width = header.width;
-	height = header.height;
-	bytesPerPixel = header.bitsperpixel >> 3;	//Convert bitsPerPixel to bytesPerPixel
-
-
-	if(width <=0){
-		in.close();
-		std::cerr << "Bad width value\n";
-		return false;
-	}
-
-	if(height <=0){
-		in.close();
-		std::cerr << "Bad height value\n";
-		return false;
-	}
-
-	if(bytesPerPixel!=GRAYSCALE && bytesPerPixel!=RGB && bytesPerPixel!=RGBA){
-		in.close();
-		std::cerr << "Bad bytesPerPixel value. Read " << bytesPerPixel << " bytes per pixel\n";
-		return false;
-	}
-
-	size_t nbytes = bytesPerPixel*width*height;
-	data = std::vector<std::uint8_t>(nbytes, 0);
-
-	//For infomation on header codes see: https://en.wikipedia.org/wiki/Truevision_TGA#Header
-	if(header.datatypecode==3 || header.datatypecode==2){ //uncompressed (3=grayscale, 2=true color)
-
-		//Read in the raw data
-		in.read(reinterpret_cast<char *>(data.data()),nbytes);
-		if(!in.good()){
-			in.close();
-			std::cerr << "An error occured while reading the raw data\n";
-			return false;
-		}
-
-	} else if(header.datatypecode==10 || header.datatypecode==11){ //run length encoded (10=true color, 11=grayscale)
-	
-		if(!load_rle_data(in)){
-			in.close();
-			std::cerr << "An error occured while reading the run length encoded data\n";
-			return false;
-		}
-
-
-	} else {
-		in.close();
-		std::cerr << "Failed to read data. Unknown file format of type " << (int)header.datatypecode << "\n";
-		return false;
-	}
-
-
-	//For orientation see: https://www.dca.fee.unicamp.br/~martino/disciplinas/ea978/tgaffs.pdf pg 9
-
-	//Objective read the data in assuming top left corner origin orientation
-
-	//Byte 5 of the image descriptor is the vertical orientation
-	//If origin at the bottom, flip to the top
-	if(!(header.imagedescriptor & 0x20)){ //(header.imagedescriptor[5]: 1=top, 0=bottom)
-		flip_vertically();
-	}
-	//Note: the image will get flipped before it is drawn
-
-
-
-	//Byte 4 of the image descriptor is the horizontal orientation
-	if(header.imagedescriptor & 0x10){ //(header.imagedescriptor[4]: 1=right, 0=left)
-		flip_horizontally();
-	}
-
-	//Orientation should now be upper left
-
-	in.close();
-	return true;
-}
-
-//Function used to load a run length encoded (rle) TGA file
-bool TGAImage::load_rle_data(std::ifstream& in){
-	size_t pixelCount = width*height;			//Expected pixel to read
-	size_t currentPixel = 0;					//Should always maintain number of pixels read and compare to expected pixels (pixelCount)
-	size_t currentByte = 0;						//Should always maintain offset into the TGAImage data field
-	TGAColor colorBuffer;
-
-	do{
-		std::uint8_t chunkHeader = 0;
-		chunkHeader = in.get();	//Read a single byte from the input stream
-		if(!(in.good())){
-			std::cerr << "An error occured when parsing the run length encoded data\n";
-			return false;
-		}
-	
-		//See http://www.paulbourke.net/dataformats/tga/ for more information on encoding packets
-		//High order bit is 1 for run length packet and 0 for raw packet
-		
-		if(chunkHeader < 128){ //Raw packet (high order bit is 0, hence less than 128)
-			//The 7 least significant bits of the header specify the number of colors that follow the header
-			
-			chunkHeader++;
-
-			for(int i=0; i<chunkHeader; i++){
-				in.read(reinterpret_cast<char*>(colorBuffer.bgra), bytesPerPixel);	//Read a full pixel into a buffer
-				if(!in.good()){
-					std::cerr << "An error occured while reading in a raw packet\n";
-					getInfo();
-					std::cerr << "Failed on pixel " << currentPixel << " of " << pixelCount;
-					std::cerr << " (Row " << currentPixel/width << " pixel " << currentPixel%width << ")\n";
-					return false;
-				}
-
-				//Copy the color from the buffer into the TGAImage object data field
-				for(int t=0; t<bytesPerPixel; t++)
-					data[currentByte++] = colorBuffer.bgra[t];
-
-
-				currentPixel++;
-				if(currentPixel > pixelCount){
-					std::cerr << "Too many pixels were read while reading raw packets\n";
-					std::cerr << "Chunk size: " << chunkHeader-0 << "\n";
-					std::cerr << "Read " << currentPixel << " but only " << pixelCount << " is allowed.\n";
-					return false;
-				}
-
-			}
-
-
-		}else{ //Run length packet (high order bit is 1, so will be 128 or greater)
-			
-			//Header value is followed by a single color value that occurs consecutively N times
-			//N is specified by the lower 7 bits of the header 
-
-			chunkHeader -= 127; //Disregard high order bit to obtain lower 7 bits of count
-
-			//Read in the color that is occurse N times consecutively
-			in.read(reinterpret_cast<char*>(colorBuffer.bgra), bytesPerPixel);
-			if(!in.good()){
-				std::cerr << "An error occured while reading in a run length packet\n";
-				return false;
-			}
-
-			for(int i=0; i<chunkHeader; i++){
-				for(int t=0; t<bytesPerPixel; t++){
-					data[currentByte++] = colorBuffer.bgra[t];
-				}
-
-				currentPixel++;
-				if(currentPixel > pixelCount){
-					std::cerr << "Too many pixels were read while reading run length packets\n";
-					return false;
-				}
-
-			}
-
-		}
-
-	} while(currentPixel < pixelCount);
-
-	return true;
-
-}
-
-//Writes data stream to  a TGA file
-bool TGAImage::write_tga_file(const std::string filename, const bool vflip, const bool rle) const {
-
-	std::uint8_t developer_area_ref[4] = {0};
-	std::uint8_t extension_area_ref[4] = {0};
-	std::uint8_t footer[18] = {'T','R','U','E','V','I','S','I','O','N','-','X','F','I','L','E','.','\0'};
-	std::ofstream out;
-	out.open(filename, std::ios::binary);
-	if(!out.is_open()){
-		std::cerr << "cant open file " << filename << " for writing\n";
-		out.close();
-		return false;
-	}
-
-	TGA_Header header;
-	header.bitsperpixel = bytesPerPixel << 3; //Convert to bits
-	header.width = width;
-	header.height = height;
-	header.datatypecode = (bytesPerPixel==GRAYSCALE ? (rle?11:3):(rle?10:2));
-	header.imagedescriptor = vflip ? 0x00 : 0x20;
-	out.write(reinterpret_cast<const char*>(&header), sizeof(header)); //Write the header
-	if(!out.good()){
-		out.close();
-		std::cerr << "Failed to dump the header to tga file\n";
-		return false;
-	}
-	if(!rle){
-		out.write(reinterpret_cast<const char*>(data.data()), width*height*bytesPerPixel);
-		if(!out.good()){
-			std::cerr << "Failed to write raw data to tga file\n";
-			out.close();
-			return false;
-		}
-	}else{
-		if(!unload_rle_data(out)){
-			out.close();
-			std::cerr << "Failed ot unload rle data to tga file\n";
-			return false;
-		}
-	}
-
-	out.write(reinterpret_cast<const char *>(developer_area_ref), sizeof(developer_area_ref));
-	if(!out.good()){
-		std::cerr << "Failed to write developer area to tga file\n";
-		out.close();
-		return false;
-	}
-
-	out.write(reinterpret_cast<const char *>(extension_area_ref), sizeof(extension_area_ref));
-	if(!out.good()){
-		std::cerr << "Failed to write extension area to tga file\n";
-		out.close();
-		return false;
-	}
-	out.write(reinterpret_cast<const char *>(footer), sizeof(footer));
-	if(!out.good()){
-		std::cerr << "Failed to write footer to tga file\n";
-		out.close();
-		return false;
-	}
-
-
-	out.close();
-	return true;
-
-}
-
-
-//Write encoding to output file
-bool TGAImage::unload_rle_data(std::ofstream &out) const{
-	const std::uint8_t max_chunk_length = 128;
-	size_t nPixels = width*height;
-	size_t currentPixel = 0;
-	while(currentPixel < nPixels){
-
-		size_t chunk_start = currentPixel*bytesPerPixel;
-		size_t currentByte = currentPixel*bytesPerPixel;
-		std::uint8_t run_length = 1;
-		bool raw = true;
-
-		//Find a chunk
-		while(currentPixel+run_length < nPixels && run_length < max_chunk_length){
-			bool nextMatches = true;
-			for(int t=0; nextMatches && t<bytesPerPixel; t++)
-				nextMatches = (data[currentByte + t] == data[currentByte+t+bytesPerPixel]); //Check if the current pixel matches the previous pixel by comparing its RGB values
-
-			currentByte += bytesPerPixel; 					//Move forward one pixel
-			
-			if(run_length == 1){							//If this is the first pixel in the run of pixels
-				raw = !nextMatches;							//If the pixel matches the next pixel, don't use a raw packet
-			}
-
-			if(raw && nextMatches){							//Raw packets should not have consecutive matching pixels		
-				run_length--;								//Back up one pixel
-				break;
-			}
-
-			if(!raw && !nextMatches){						//Run length packets (non-raw packets) should have consecutive matching pixels
-				break;										//If the next doesn't match, leave it for the next packet
-			}
-
-			run_length++;
-		}
-
-		currentPixel += run_length;							//Move the currentPixel forward the number of pixels handled in the current packet
-
-
-		//See http://www.paulbourke.net/dataformats/tga/ for more information on encoding packets
-		//Write the packet header
-		out.put(raw?run_length-1:run_length+127);
-		//std::cerr << "Wrote packet header: " << (raw?run_length-1:run_length+127) << "\n";
-		if(!out.good()){
-			std::cerr << "Failed to write a packet header to tga file\n";
-			return false;
-		}
-
-		//Write the packet body
-		out.write(reinterpret_cast<const char *>(data.data()+chunk_start), (raw?run_length*bytesPerPixel:bytesPerPixel));
-		// std::cerr << "Wrote packet body: " << (raw?run_length-1:run_length+127) << "\n";
-		//Raw pixels should copy each pixel data consecutively, run length packets copy a single pixel that is copied the number of times in the packet header
-		if(!out.good()){
-			std::cerr << "Failed to write packet body to tga file\n";
-			return false;
-		}
-
-	}
-
-	return true;
-
-}
-
-
-
-//Mirrors pixels over the vertical axis
-void TGAImage::flip_horizontally(){
-	if(!data.size()) return;
-	int half = width >> 1;
-
-	for(int i=0; i<half; i++){
-		for(int j=0; j<height; j++){
-			TGAColor c1  = get(i, j);
-			TGAColor c2 = get(width-i-1, j);
-			set(i,j, c2);
-			set(width-i-1, j, c1);
-		}
-	}
-}
-
-//Mirrors pixels over the horizontal axis
-void TGAImage::flip_vertically(){
-	if(!data.size()) return;
-	size_t bytes_per_line = width*bytesPerPixel; //Flip entire rows
-	std::vector<std::uint8_t> pixelBuffer(bytes_per_line, 0);
-	int half = height >> 1;
-	for(int j=0; j<half; j++){
-		size_t l1 = j*bytes_per_line; //Get offset of first line
-		size_t l2 = (height-j-1)*bytes_per_line; //Get offset of second line
-
-		//Perform data swap using pixel buffer as temporary hold
-		std::copy(data.begin()+l1, data.begin()+l1+bytes_per_line, pixelBuffer.begin());
-		std::copy(data.begin()+l2, data.begin()+l2+bytes_per_line, data.begin()+l1);
-		std::copy(pixelBuffer.begin(), pixelBuffer.end(), data.begin()+l2);
-	}
-
-}
-
-
-//Scale the TGA Image
-void TGAImage::scale(const int w, const int h){
-	if(w<=0 || h<=0 || !data.size()) return;
-	std::vector<std::uint8_t>scaledData(w*h*bytesPerPixel, 0);
-
-	int scaledScanline = 0; 						//Current scan line of the scaled image
-	int baseScanline = 0;							//Current scan line of the original image
-	size_t scaledLineBytes = w*bytesPerPixel;	 	//Bytes in per line in the scaled image
-	size_t baseLineBytes = width*bytesPerPixel;		//Bytes in per line in the original image
-
-	int erry=0;										//Control for copying rows according to the ratio of height
-
-
-	for(int j=0; j<height; j++){
-		int errx = width-w;							//Control for copying the pixels according to ratio of widths
-		int scaledX = -bytesPerPixel;				//x-pos of pixel in current row of scaled image
-		int baseX = -bytesPerPixel; 				//x-pos of pixel in current row of original image
-
-		for(int i=0; i<width; i++){
-			baseX += bytesPerPixel;					//Iterate to next pixel
-			errx += w;								
-													//If width > w, this will copy a pixel over less than once per pixel of the original image (downsampling)
-													//If width < w, this will copy a pixel over more than once per pixel of the original image (upsampling)
-													//If width == w, every pixel will get copied over exactly once
-			while(errx >= width){					
-				errx -= width;
-				scaledX += bytesPerPixel;
-				memcpy(scaledData.data()+scaledScanline+scaledX, data.data()+baseScanline+baseX, bytesPerPixel);
-			}
-
-		}
-
-
-		erry += h;
-		baseScanline += baseLineBytes;				//Iterate to next row of original image
-
-													//If height > h, the scaled image row variable "scaledScanline" will increment infrequently, the if statement will never evaluate to true
-													//The while loop above will overwrite data frequently producing a image of less height (downsampling)
-													//If height < h, occasionally "erry" will become twice as large as height, and a row will be duplicated (upsampling)
-													//If height == h, the below while loop will always complete one iteration, but the if statement will never evaluate to true
-
-		while(erry >= height){
-			if(erry >= height << 1)					//Used to duplicate row n onto n+1 (upsampling height)
-				memcpy(scaledData.data()+scaledScanline+scaledLineBytes, scaledData.data()+scaledScanline, scaledLineBytes);
-			erry -=height;
-			scaledScanline += scaledLineBytes; 		//Iterate to next row of scaled image
-
-
-		}
-
-
-	}
-
-	//Update data to reflect the scaled image
-	data = scaledData;
-	width = w;
-	height = h;
-
-}
-
-
-//Get pixel color
-TGAColor TGAImage::get(const int x, const int y) const{
-
-	if(!data.size() || x < 0 || x >= width || y<0 || y>=height) return {};
-	return TGAColor(data.data()+(x+y*width)*bytesPerPixel, bytesPerPixel);
-
-}	
-
-//Set pixel color
-void TGAImage::set(const int x, const int y, const TGAColor &c){
-	if(!data.size() || x<0 || x>=width || y<0 || y>=height) return;
-	memcpy(data.data()+(x+y*width)*bytesPerPixel, c.bgra, bytesPerPixel);
-}
-
-//Get TGA Image width
-int TGAImage::get_width() const{
-	return width;
-}
-
-//Get TGA Image height
-int TGAImage::get_height() const{
-	return height;
-}
-
-//Get TGA Image bytes per pixel
-int TGAImage::get_bytespp(){
-	return bytesPerPixel;
-}
-
-//Get the TGA Image data buffer
-std::uint8_t* TGAImage::buffer(){
-	return data.data();
-}
-
-//Clear the data buffer
-void TGAImage::clear(){
-	data = std::vector<std::uint8_t>(width*height*bytesPerPixel, 0);
-}
-
-//Debugging Information
-void TGAImage::getInfo(){
-	std::cerr << "TGA size: " << width <<"x" << height << "\n";
-	std::cerr << "Pixels storage: " << bytesPerPixel << " bytes/pixel\n";
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <cstring>
+#include <thread>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "TGAImage.h"
+#include "Resample.h"
+#include "Qoi.h"
+#include "StripeWriter.h"
+
+#define PPM_STRIPE_BYTES (256 << 10)			//Bytes of rows write_ppm_file hands over at a time, at least one row
+
+//Default constructor
+TGAImage::TGAImage(): data(), mapping(), view(nullptr), width(0), height(0), bytesPerPixel(0), origin(TOP_LEFT){}
+
+//Constructor by value
+TGAImage::TGAImage(const int _width, const int _height, const int _bpp) :
+				data(_width*_height*_bpp, 0), mapping(), view(nullptr), width(_width), height(_height), bytesPerPixel(_bpp), origin(TOP_LEFT) {}
+
+
+//Read in a TGA file
+bool TGAImage::read_tga_file(const std::string filename){
+
+	std::ifstream in;
+	in.open(filename, std::ios::binary);
+	if(!in.is_open()){
+		std::cerr << "Can't open file " << filename << "\n";
+		in.close();
+		return false;
+	}
+	const bool ok = read_tga(in);
+	in.close();
+	return ok;
+}
+
+//Read a TGA image from a binary stream, positioned at its header (a file, or memory through a stringstream)
+bool TGAImage::read_tga(std::istream& in){
+
+	//Retrieve the TGA header
+	TGA_Header header;
+	//Bytes are packed sequentially so read sizeof(header) bytes into the casted char pointer
+	in.read(reinterpret_cast<char *>(&header), sizeof(header));
+	if(!in.good()){
+		std::cerr << "An error occured while reading the header\n";
+		return false;
+	}
+
+	//read values from the header
+	width = header.width;
+	height = header.height;
+	bytesPerPixel = header.bitsperpixel >> 3;	//Convert bitsPerPixel to bytesPerPixel
+
+
+	if(width <=0){
+		std::cerr << "Bad width value\n";
+		return false;
+	}
+
+	if(height <=0){
+		std::cerr << "Bad height value\n";
+		return false;
+	}
+
+	if(bytesPerPixel!=GRAYSCALE && bytesPerPixel!=RGB && bytesPerPixel!=RGBA){
+		std::cerr << "Bad bytesPerPixel value. Read " << bytesPerPixel << " bytes per pixel\n";
+		return false;
+	}
+
+	size_t nbytes = size_t(bytesPerPixel)*width*height;
+	data.resize(nbytes);							//Keeps the buffer of a reused image
+	mapping.reset();
+	view = nullptr;
+
+	//The image ID and the color map (unused for true color and grayscale images) come before the pixels
+	in.seekg(header.idlength + (header.colormaptype ? header.colormaplength*((header.colormapdepth+7) >> 3) : 0), std::ios::cur);
+
+	//For infomation on header codes see: https://en.wikipedia.org/wiki/Truevision_TGA#Header
+	if(header.datatypecode==3 || header.datatypecode==2){ //uncompressed (3=grayscale, 2=true color)
+
+		//Read in the raw data
+		in.read(reinterpret_cast<char *>(data.data()),nbytes);
+		if(!in.good()){
+			std::cerr << "An error occured while reading the raw data\n";
+			return false;
+		}
+
+	} else if(header.datatypecode==10 || header.datatypecode==11){ //run length encoded (10=true color, 11=grayscale)
+
+		//Read the rest of the file at once and decode it from memory
+		std::streampos start = in.tellg();
+		in.seekg(0, std::ios::end);
+		std::streamoff size = in.tellg()-start;
+		in.seekg(start);
+		std::vector<std::uint8_t> encoded(size > 0 ? size : 0);
+		in.read(reinterpret_cast<char *>(encoded.data()), encoded.size());
+		if(!in.good() || !load_rle_data(encoded.data(), encoded.size())){
+			std::cerr << "An error occured while reading the run length encoded data\n";
+			return false;
+		}
+
+
+	} else {
+		std::cerr << "Failed to read data. Unknown file format of type " << (int)header.datatypecode << "\n";
+		return false;
+	}
+
+
+	//For orientation see: https://www.dca.fee.unicamp.br/~martino/disciplinas/ea978/tgaffs.pdf pg 9
+	//Bits 5 (1=top, 0=bottom) and 4 (1=right, 0=left) of the image descriptor give the corner the data starts at
+	//The data is kept in file order, get() and set() read it from the top left (see set_origin to reorder it)
+	origin = header.imagedescriptor & TOP_RIGHT;
+
+	return true;
+}
+
+//Read in a QOI file (see Qoi.h), the image gets its 3 or 4 channels and starts at the top left
+bool TGAImage::read_qoi_file(const std::string filename){
+	std::ifstream in(filename, std::ios::binary | std::ios::ate);
+	if(!in.is_open()){
+		std::cerr << "Can't open file " << filename << "\n";
+		return false;
+	}
+	std::vector<std::uint8_t> encoded(size_t(std::max<std::streamoff>(in.tellg(), 0)));
+	in.seekg(0);
+	in.read(reinterpret_cast<char *>(encoded.data()), encoded.size());
+	if(!in.good()){
+		std::cerr << "An error occured while reading " << filename << "\n";
+		return false;
+	}
+
+	int w, h, channels;
+	mapping.reset();
+	view = nullptr;
+	if(!qoiDecode(encoded.data(), encoded.size(), w, h, channels, data)){
+		data.clear();
+		width = height = 0;
+		return false;
+	}
+	width = w;
+	height = h;
+	bytesPerPixel = channels;
+	origin = TOP_LEFT;
+	return true;
+}
+
+//Next number of a PPM header, false at the end of the file or on anything else
+//Whitespace and comments (# to the end of the line) are skipped
+static bool ppmNumber(std::istream& in, int& value){
+	int c = in.get();
+	while(c == '#' || std::isspace(c)){
+		if(c == '#') while(c != '\n' && c != EOF) c = in.get();
+		c = in.get();
+	}
+	if(!std::isdigit(c)) return false;
+	value = 0;
+	for(; std::isdigit(c); c = in.get()){
+		if(value > 0xFFFFFFF) return false;
+		value = value*10 + (c-'0');
+	}
+	return std::isspace(c);						//One whitespace character ends the header
+}
+
+//Read in a binary PPM (P6) or PGM (P5) file of up to 255 levels, the image starts at the top left
+//P6 becomes RGB with the channels in TGA order, P5 grayscale
+bool TGAImage::read_ppm_file(const std::string filename){
+	std::ifstream in(filename, std::ios::binary);
+	if(!in.is_open()){
+		std::cerr << "Can't open file " << filename << "\n";
+		return false;
+	}
+	char magic[2] = {0, 0};
+	in.read(magic, 2);
+	int w, h, maxval;
+	if(magic[0] != 'P' || (magic[1] != '5' && magic[1] != '6') || !ppmNumber(in, w) || !ppmNumber(in, h) || !ppmNumber(in, maxval) ||
+			w <= 0 || h <= 0 || maxval <= 0){
+		std::cerr << filename << " isn't a binary PPM or PGM file\n";
+		return false;
+	}
+	if(maxval > 255){
+		std::cerr << "16 bit PPM files aren't supported\n";
+		return false;
+	}
+
+	const int bpp = magic[1] == '6' ? RGB : GRAYSCALE;
+	const size_t nbytes = size_t(w)*h*bpp;
+	mapping.reset();
+	view = nullptr;
+	data.resize(nbytes);
+	in.read(reinterpret_cast<char *>(data.data()), nbytes);
+	if(!in.good()){
+		std::cerr << "An error occured while reading the pixels of " << filename << "\n";
+		data.clear();
+		width = height = 0;
+		return false;
+	}
+	width = w;
+	height = h;
+	bytesPerPixel = bpp;
+	origin = TOP_LEFT;
+
+	std::uint8_t* p = data.data();
+	if(maxval != 255)
+		for(size_t i=0; i<nbytes; i++) p[i] = std::min(255, (p[i]*255 + maxval/2)/maxval);
+	if(bpp == RGB)
+		for(size_t i=0; i<nbytes; i+=3) std::swap(p[i], p[i+2]);
+	return true;
+}
+
+//Read only mapping of a whole file, unmapped with the last image using it
+struct MappedFile {
+	void* address;
+	size_t length;
+
+	MappedFile(void* a, const size_t l) : address(a), length(l) {}
+#if defined(__unix__) || defined(__APPLE__)
+	~MappedFile(){ munmap(address, length); }
+#endif
+};
+
+//Open an uncompressed TGA file in place: the pixels stay in the mapped file and are only copied into the image's own
+//memory when something writes to them (set, buffer, a flip or a scale), reading them costs no allocation or copy
+//Run length encoded files and systems without mmap go through read_tga_file
+//The file has to stay as it is while the image maps it (see mapping in TGAImage.h), use read_tga_file for files that can
+//change, such as an output the program writes again
+bool TGAImage::map_tga_file(const std::string filename){
+#if defined(__unix__) || defined(__APPLE__)
+	int fd = open(filename.c_str(), O_RDONLY);
+	if(fd < 0){
+		std::cerr << "Can't open file " << filename << "\n";
+		return false;
+	}
+	struct stat st;
+	if(fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(TGA_Header)){
+		close(fd);
+		return read_tga_file(filename);						//Reports what is wrong with the file
+	}
+	void* address = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(address == MAP_FAILED) return read_tga_file(filename);
+	std::shared_ptr<const MappedFile> file = std::make_shared<const MappedFile>(address, st.st_size);
+
+	TGA_Header header;
+	memcpy(&header, address, sizeof(header));
+	const int bpp = header.bitsperpixel >> 3;
+	const size_t offset = sizeof(header) + header.idlength + (header.colormaptype ? header.colormaplength*((header.colormapdepth+7) >> 3) : 0);
+	const size_t nbytes = size_t(bpp)*header.width*header.height;
+	if((header.datatypecode != 2 && header.datatypecode != 3) || (bpp != GRAYSCALE && bpp != RGB && bpp != RGBA) ||
+			nbytes == 0 || offset+nbytes > file->length)
+		return read_tga_file(filename);
+
+	width = header.width;
+	height = header.height;
+	bytesPerPixel = bpp;
+	origin = header.imagedescriptor & TOP_RIGHT;
+	std::vector<std::uint8_t>().swap(data);
+	mapping = file;
+	view = static_cast<const std::uint8_t*>(address) + offset;
+	return true;
+#else
+	return read_tga_file(filename);
+#endif
+}
+
+//Fill count pixels at dst with the pixel at src
+static inline void fillPixels(std::uint8_t* dst, const std::uint8_t* src, const size_t count, const int bpp){
+	if(bpp == TGAImage::GRAYSCALE){
+		memset(dst, src[0], count);
+	}else if(bpp == TGAImage::RGBA){
+		std::uint32_t pixel;
+		memcpy(&pixel, src, 4);
+		for(size_t i=0; i<count; i++) memcpy(dst+4*i, &pixel, 4);
+	}else{
+		//Copy the first pixel, then the filled part onto the rest, doubling it every time
+		memcpy(dst, src, bpp);
+		const size_t total = count*bpp;
+		for(size_t filled=bpp; filled<total; filled*=2) memcpy(dst+filled, dst, std::min(filled, total-filled));
+	}
+}
+
+//Function used to load a run length encoded (rle) TGA file from the size bytes at in, which follow the header
+//Raw packets are one copy and runs one fill, the bounds are checked once per packet
+bool TGAImage::load_rle_data(const std::uint8_t* in, const size_t size){
+	const size_t pixelCount = size_t(width)*height;		//Expected pixel to read
+	const size_t byteCount = pixelCount*bytesPerPixel;
+	size_t currentByte = 0;								//Offset into the TGAImage data field
+	size_t position = 0;								//Offset into the encoded data
+
+	while(currentByte < byteCount){
+		if(position >= size){
+			std::cerr << "The run length encoded data ends after " << currentByte/bytesPerPixel << " of " << pixelCount << " pixels\n";
+			return false;
+		}
+
+		//See http://www.paulbourke.net/dataformats/tga/ for more information on encoding packets
+		//High order bit is 1 for run length packet and 0 for raw packet, the 7 low bits are the number of pixels - 1
+		const std::uint8_t chunkHeader = in[position++];
+		const bool raw = chunkHeader < 128;
+		const size_t count = raw ? chunkHeader+1 : chunkHeader-127;
+		const size_t bytes = count*bytesPerPixel;
+		if(currentByte+bytes > byteCount){
+			std::cerr << "Too many pixels were read while reading " << (raw ? "raw" : "run length") << " packets\n";
+			std::cerr << "Chunk size: " << count << ", " << (byteCount-currentByte)/bytesPerPixel << " pixels were left\n";
+			return false;
+		}
+		if(position+(raw ? bytes : bytesPerPixel) > size){
+			std::cerr << "An error occured while reading in a " << (raw ? "raw" : "run length") << " packet\n";
+			getInfo();
+			std::cerr << "Failed on pixel " << currentByte/bytesPerPixel << " of " << pixelCount << "\n";
+			return false;
+		}
+
+		if(raw){	//Pixels follow the header one after the other
+			memcpy(data.data()+currentByte, in+position, bytes);
+			position += bytes;
+		}else{		//A single pixel follows the header, repeated count times
+			fillPixels(data.data()+currentByte, in+position, count, bytesPerPixel);
+			position += bytesPerPixel;
+		}
+		currentByte += bytes;
+	}
+
+	return true;
+
+}
+
+//Writes data stream to  a TGA file
+bool TGAImage::write_tga_file(const std::string filename, const bool vflip, const bool rle, const int nThreads) const {
+
+	std::ofstream out;
+	out.open(filename, std::ios::binary);
+	if(!out.is_open()){
+		std::cerr << "cant open file " << filename << " for writing\n";
+		out.close();
+		return false;
+	}
+	const bool ok = write_tga(out, vflip, rle, nThreads);
+	out.close();
+	return ok;
+}
+
+//Writes the image as a TGA file to a binary stream (a file, or memory through a stringstream), see write_tga_file
+bool TGAImage::write_tga(std::ostream& out, const bool vflip, const bool rle, const int nThreads) const {
+
+	std::uint8_t developer_area_ref[4] = {0};
+	std::uint8_t extension_area_ref[4] = {0};
+	std::uint8_t footer[18] = {'T','R','U','E','V','I','S','I','O','N','-','X','F','I','L','E','.','\0'};
+
+	TGA_Header header;
+	header.bitsperpixel = bytesPerPixel << 3; //Convert to bits
+	header.width = width;
+	header.height = height;
+	header.datatypecode = (bytesPerPixel==GRAYSCALE ? (rle?11:3):(rle?10:2));
+	header.imagedescriptor = vflip ? origin^TOP_LEFT : origin;	//The data goes out as it is, vflip only changes the origin it is read from
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header)); //Write the header
+	if(!out.good()){
+		std::cerr << "Failed to dump the header to tga file\n";
+		return false;
+	}
+	if(!rle){
+		out.write(reinterpret_cast<const char*>(pixels()), size_t(width)*height*bytesPerPixel);
+		if(!out.good()){
+			std::cerr << "Failed to write raw data to tga file\n";
+			return false;
+		}
+	}else{
+		if(!unload_rle_data(out, nThreads)){
+			std::cerr << "Failed ot unload rle data to tga file\n";
+			return false;
+		}
+	}
+
+	out.write(reinterpret_cast<const char *>(developer_area_ref), sizeof(developer_area_ref));
+	if(!out.good()){
+		std::cerr << "Failed to write developer area to tga file\n";
+		return false;
+	}
+
+	out.write(reinterpret_cast<const char *>(extension_area_ref), sizeof(extension_area_ref));
+	if(!out.good()){
+		std::cerr << "Failed to write extension area to tga file\n";
+		return false;
+	}
+	out.write(reinterpret_cast<const char *>(footer), sizeof(footer));
+	if(!out.good()){
+		std::cerr << "Failed to write footer to tga file\n";
+		return false;
+	}
+
+	return true;
+
+}
+
+
+//Writes the image to a QOI file (see Qoi.h) a row at a time, vflip as for write_tga_file
+//QOI rows always go from the top left, the rows and pixels are taken in the order that gives the same picture
+bool TGAImage::write_qoi_file(const std::string filename, const bool vflip) const {
+	const int from = vflip ? origin^TOP_LEFT : origin;
+	const std::uint8_t* d = pixels();
+	if(!d) return false;
+	QoiEncoder encoder;
+	if(!encoder.open(filename, width, height, bytesPerPixel == RGBA ? 4 : 3)) return false;
+	const size_t pitch = size_t(width)*bytesPerPixel;
+	for(int y=0; y<height; y++){
+		const int row = from & TOP_LEFT ? y : height-1-y;
+		if(!encoder.writeRow(d + row*pitch, bytesPerPixel, from & BOTTOM_RIGHT)) return false;
+	}
+	return encoder.close();
+}
+
+//Writes the image to a binary PPM file (P6, P5 for grayscale, alpha is dropped), vflip as for write_tga_file
+//PPM has no size limit, unlike TGA. Rows go out as stripes of the data (see StripeWriter)
+bool TGAImage::write_ppm_file(const std::string filename, const bool vflip) const {
+	const int from = vflip ? origin^TOP_LEFT : origin;
+	const std::uint8_t* d = pixels();
+	if(!d) return false;
+	StripeWriter writer;
+	if(!writer.open(filename, width, height, bytesPerPixel, StripeWriter::PPM)) return false;
+
+	const std::ptrdiff_t pitch = std::ptrdiff_t(width)*bytesPerPixel;
+	if(!(from & BOTTOM_RIGHT)){
+		//Stripes of rows straight from the data, taken from the last row up if it starts at the bottom
+		//A stripe is converted to RGB in the writer, so it is kept small whatever the image size
+		const int stripe = int(std::max<std::ptrdiff_t>(1, PPM_STRIPE_BYTES/pitch));
+		for(int y=0; y<height; y+=stripe){
+			const int n = std::min(stripe, height-y);
+			const bool ok = from & TOP_LEFT ? writer.write(d + y*pitch, n, pitch) : writer.write(d + (height-1-y)*pitch, n, -pitch);
+			if(!ok) return false;
+		}
+		return writer.close();
+	}
+	std::vector<std::uint8_t> row(pitch);
+	for(int y=0; y<height; y++){
+		const std::uint8_t* src = d + (from & TOP_LEFT ? y : height-1-y)*pitch;
+		for(int x=0; x<width; x++) memcpy(&row[x*bytesPerPixel], src + (width-1-x)*bytesPerPixel, bytesPerPixel);
+		if(!writer.write(row.data(), 1, pitch)) return false;
+	}
+	return writer.close();
+}
+
+//Whether the pixels at a and b are the same
+static inline bool samePixel(const std::uint8_t* a, const std::uint8_t* b, const int bpp){
+	for(int t=0; t<bpp; t++)
+		if(a[t] != b[t]) return false;
+	return true;
+}
+
+//First pixel i in [from,to) whose equality with pixel i+1 is equal, to if there is none (pixel to must exist)
+//SSE2 compares 16 bytes against the 16 bytes one pixel further and keeps the pixels whose bytes all matched
+static size_t findPixel(const std::uint8_t* d, size_t from, const size_t to, const int bpp, const bool equal){
+#if defined(__SSE2__)
+	const int lanes = bpp==TGAImage::GRAYSCALE ? 16 : bpp==TGAImage::RGB ? 5 : 4;
+	const int pixelBits = bpp==TGAImage::GRAYSCALE ? 0xFFFF : bpp==TGAImage::RGB ? 0x1249 : 0x1111;	//Bit of each pixel's first byte
+	while(from+lanes <= to && (from+1)*bpp+16 <= (to+1)*bpp){		//Both loads stay inside pixels [from,to]
+		const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(d+from*bpp));
+		const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(d+(from+1)*bpp));
+		const int bytes = _mm_movemask_epi8(_mm_cmpeq_epi8(a, b));
+		int pixels = bytes;
+		for(int t=1; t<bpp; t++) pixels &= bytes >> t;				//A pixel matches if its bpp bytes do
+		pixels = (equal ? pixels : ~pixels) & pixelBits;
+		if(pixels) return from + __builtin_ctz(pixels)/bpp;
+		from += lanes;
+	}
+#endif
+	for(; from<to; from++)
+		if(samePixel(d+from*bpp, d+(from+1)*bpp, bpp) == equal) return from;
+	return to;
+}
+
+//Growing buffer of encoded packets
+struct PacketBuffer {
+	std::vector<std::uint8_t> bytes;
+	size_t used = 0;
+
+	//Room for n more bytes
+	std::uint8_t* reserve(const size_t n){
+		if(used+n > bytes.size()) bytes.resize(std::max(2*bytes.size(), used+n));
+		return bytes.data()+used;
+	}
+};
+
+//Append the RLE packet starting at pixel cur of n to out, returns the number of pixels it covers
+//Runs cover a pixel and the pixels equal to it, raw packets stop before two equal pixels (128 pixels at most either way)
+static size_t rlePacket(const std::uint8_t* d, const size_t cur, const size_t n, const int bpp, PacketBuffer& out){
+	const size_t limit = std::min(cur+127, n-1);		//Last pixel the packet's comparisons may look at
+	size_t length;
+	const bool raw = !(cur+1 < n && samePixel(d+cur*bpp, d+(cur+1)*bpp, bpp));
+	if(!raw){
+		length = findPixel(d, cur, limit, bpp, false)-cur+1;
+	}else{
+		const size_t next = findPixel(d, cur+1, limit, bpp, true);
+		length = next < limit ? next-cur : std::min<size_t>(128, n-cur);
+	}
+
+	//See http://www.paulbourke.net/dataformats/tga/ for more information on encoding packets
+	const size_t body = raw ? length*bpp : bpp;
+	std::uint8_t* p = out.reserve(1+body);
+	p[0] = raw ? length-1 : length+127;
+	memcpy(p+1, d+cur*bpp, body);
+	out.used += 1+body;
+	return length;
+}
+
+//Size in pixels of the packet whose header is h
+static inline size_t packetPixels(const std::uint8_t h){
+	return h < 128 ? h+1 : h-127;
+}
+
+//Write encoding to output file
+//Packets are encoded into memory and written in large blocks. Images of a few million pixels are split into bands
+//encoded by separate threads, each starting a packet at its first pixel. Packets only depend on where they start, so a
+//band holds exactly what a single pass makes once the packets before it end on one of its packet starts: the few
+//packets between the end of a band and that point are encoded again
+bool TGAImage::unload_rle_data(std::ostream &out, const int nThreads) const{
+	const size_t nPixels = size_t(width)*height;
+	const std::uint8_t* d = pixels();
+	const int threads = nThreads > 0 ? nThreads : std::max(1u, std::thread::hardware_concurrency());
+	const int nBands = std::max<size_t>(1, std::min<size_t>(threads, nPixels >> 20));	//A million pixels a band at least
+	const size_t block = 1 << 20;						//Bytes written at a time by a single pass
+
+	if(nBands == 1){
+		PacketBuffer buffer;
+		buffer.bytes.resize(block + 1+128*bytesPerPixel);
+		for(size_t cur=0; cur<nPixels; ){
+			cur += rlePacket(d, cur, nPixels, bytesPerPixel, buffer);
+			if(buffer.used >= block || cur == nPixels){
+				out.write(reinterpret_cast<const char*>(buffer.bytes.data()), buffer.used);
+				buffer.used = 0;
+				if(!out.good()){
+					std::cerr << "Failed to write packets to tga file\n";
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	struct Band {
+		size_t start, end;								//First pixel and the pixel after the last packet
+		PacketBuffer packets;
+	};
+	std::vector<Band> bands(nBands);
+	auto encode = [&](const int b){
+		Band& band = bands[b];
+		band.start = nPixels*b/nBands;
+		const size_t stop = nPixels*(b+1)/nBands;
+		band.packets.bytes.resize((stop-band.start)*bytesPerPixel*9/8 + 1+128*bytesPerPixel);
+		size_t cur = band.start;
+		while(cur < stop) cur += rlePacket(d, cur, nPixels, bytesPerPixel, band.packets);
+		band.end = cur;
+	};
+	std::vector<std::thread> workers;
+	for(int b=1; b<nBands; b++) workers.emplace_back(encode, b);
+	encode(0);
+	for(std::thread& t : workers) t.join();
+
+	size_t cur = 0;
+	PacketBuffer patch;
+	for(const Band& band : bands){
+		//Catch the single pass up with the band: encode from cur until it lands on one of the band's packet starts
+		const std::uint8_t* packets = band.packets.bytes.data();
+		size_t start = band.start, offset = 0;
+		patch.used = 0;
+		while(cur != start){
+			if(cur < start){
+				cur += rlePacket(d, cur, nPixels, bytesPerPixel, patch);
+			}else if(offset < band.packets.used){
+				const size_t length = packetPixels(packets[offset]);
+				offset += 1 + (packets[offset] < 128 ? length*bytesPerPixel : bytesPerPixel);
+				start += length;
+			}else{
+				break;									//The single pass went past the whole band
+			}
+		}
+		out.write(reinterpret_cast<const char*>(patch.bytes.data()), patch.used);
+		if(cur == start){
+			out.write(reinterpret_cast<const char*>(packets+offset), band.packets.used-offset);
+			cur = band.end;
+		}
+		if(!out.good()){
+			std::cerr << "Failed to write packets to tga file\n";
+			return false;
+		}
+	}
+
+	return true;
+
+}
+
+
+//Reverse the order of the pixels of a row in place
+//SSE2 swaps a block of pixels from each end at a time: 16 gray, 5 RGB or 4 RGBA pixels per 16 byte register
+static void reverseRow(std::uint8_t* row, const int width, const int bpp){
+	int i = 0, j = width-1;							//Next pixels to swap from the left and from the right
+#if defined(__SSE2__)
+	const int lanes = bpp==TGAImage::GRAYSCALE ? 16 : bpp==TGAImage::RGB ? 5 : 4;
+	if(bpp == TGAImage::RGB){
+		//An RGB pixel k of a register moves to 4-k by a byte shift. A register's 16th byte belongs to the next pixel and
+		//is put back as it was, so a pixel is kept between the two blocks for the byte both registers overhang
+		const __m128i p0 = _mm_setr_epi8(-1,-1,-1,0,0,0,0,0,0,0,0,0,0,0,0,0);
+		const __m128i p1 = _mm_slli_si128(p0, 3), p2 = _mm_slli_si128(p0, 6), p3 = _mm_slli_si128(p0, 9), p4 = _mm_slli_si128(p0, 12);
+		const __m128i first = _mm_setr_epi8(-1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0);
+		const __m128i last = _mm_slli_si128(first, 15);
+		auto reverse5 = [&](const __m128i x){
+			return _mm_or_si128(_mm_or_si128(_mm_slli_si128(_mm_and_si128(x, p0), 12), _mm_slli_si128(_mm_and_si128(x, p1), 6)),
+						_mm_or_si128(_mm_and_si128(x, p2), _mm_or_si128(_mm_srli_si128(_mm_and_si128(x, p3), 6), _mm_srli_si128(_mm_and_si128(x, p4), 12))));
+		};
+		for(; j-i+1 > 2*lanes; i+=lanes, j-=lanes){
+			__m128i* l = reinterpret_cast<__m128i*>(row+i*bpp);
+			__m128i* r = reinterpret_cast<__m128i*>(row+(j+1)*bpp-16);
+			const __m128i a = _mm_loadu_si128(l), b = _mm_loadu_si128(r);
+			_mm_storeu_si128(l, _mm_or_si128(reverse5(_mm_srli_si128(b, 1)), _mm_and_si128(a, last)));
+			_mm_storeu_si128(r, _mm_or_si128(_mm_slli_si128(reverse5(a), 1), _mm_and_si128(b, first)));
+		}
+	}else{
+		auto reverse = [&](__m128i x){
+			x = _mm_shuffle_epi32(x, 0x1B);			//Reverse the 4 byte pixels
+			if(bpp == TGAImage::GRAYSCALE){				//Then the 2 byte halves of each and the bytes of each half
+				x = _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0xB1), 0xB1);
+				x = _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+			}
+			return x;
+		};
+		for(; j-i+1 >= 2*lanes; i+=lanes, j-=lanes){
+			__m128i* l = reinterpret_cast<__m128i*>(row+i*bpp);
+			__m128i* r = reinterpret_cast<__m128i*>(row+(j+1)*bpp-16);
+			const __m128i a = _mm_loadu_si128(l), b = _mm_loadu_si128(r);
+			_mm_storeu_si128(l, reverse(b));
+			_mm_storeu_si128(r, reverse(a));
+		}
+	}
+#endif
+	for(; i<j; i++, j--)
+		for(int t=0; t<bpp; t++) std::swap(row[i*bpp+t], row[j*bpp+t]);
+}
+
+//Mirrors pixels over the vertical axis, one row at a time
+void TGAImage::flip_horizontally(){
+	detach();
+	if(!data.size()) return;
+	size_t bytes_per_line = width*bytesPerPixel;
+	for(int j=0; j<height; j++)
+		reverseRow(data.data()+j*bytes_per_line, width, bytesPerPixel);
+}
+
+//Mirrors pixels over the horizontal axis
+void TGAImage::flip_vertically(){
+	detach();
+	if(!data.size()) return;
+	size_t bytes_per_line = width*bytesPerPixel; //Flip entire rows
+	int half = height >> 1;
+	for(int j=0; j<half; j++){
+		size_t l1 = j*bytes_per_line; //Get offset of first line
+		size_t l2 = (height-j-1)*bytes_per_line; //Get offset of second line
+		std::swap_ranges(data.begin()+l1, data.begin()+l1+bytes_per_line, data.begin()+l2);
+	}
+
+}
+
+
+//Scale the TGA Image to w x h with a filter (see resample), nThreads 0 uses every core
+//A mapped image is read in place, the scaled pixels are the image's own
+void TGAImage::scale(const int w, const int h, const Filter filter, const int nThreads){
+	if(w<=0 || h<=0 || !pixels() || !width || !height) return;
+	std::vector<std::uint8_t> scaledData(size_t(w)*h*bytesPerPixel);
+	resample(pixels(), width, height, bytesPerPixel, scaledData.data(), w, h, filter, nThreads);
+
+	//Update data to reflect the scaled image
+	data.swap(scaledData);
+	view = nullptr;
+	mapping.reset();
+	width = w;
+	height = h;
+}
+
+//Scale into dst (see above) and leave this image as it is, dst keeps its buffer when it is large enough
+//so an image reused for many scales allocates once. The data keeps its order, dst gets this image's origin
+void TGAImage::scale(TGAImage& dst, const int w, const int h, const Filter filter, const int nThreads) const{
+	if(w<=0 || h<=0 || !pixels() || !width || !height || &dst == this) return;
+	dst.mapping.reset();
+	dst.view = nullptr;
+	dst.data.resize(size_t(w)*h*bytesPerPixel);
+	dst.width = w;
+	dst.height = h;
+	dst.bytesPerPixel = bytesPerPixel;
+	dst.origin = origin;
+	resample(pixels(), width, height, bytesPerPixel, dst.data.data(), w, h, filter, nThreads);
+}
+
+
+//Get pixel color
+TGAColor TGAImage::get(const int x, const int y) const{
+
+	const std::uint8_t* p = pixels();
+	if(!p || x < 0 || x >= width || y<0 || y>=height) return {};
+	const int row = (origin & TOP_LEFT) ? y : height-1-y, column = (origin & BOTTOM_RIGHT) ? width-1-x : x;
+	return TGAColor(p+(column+row*width)*bytesPerPixel, bytesPerPixel);
+
+}	
+
+//Set pixel color
+void TGAImage::set(const int x, const int y, const TGAColor &c){
+	if(view) detach();
+	if(!data.size() || x<0 || x>=width || y<0 || y>=height) return;
+	const int row = (origin & TOP_LEFT) ? y : height-1-y, column = (origin & BOTTOM_RIGHT) ? width-1-x : x;
+	memcpy(data.data()+(column+row*width)*bytesPerPixel, c.bgra, bytesPerPixel);
+}
+
+//Get TGA Image width
+int TGAImage::get_width() const{
+	return width;
+}
+
+//Get TGA Image height
+int TGAImage::get_height() const{
+	return height;
+}
+
+//Get TGA Image bytes per pixel
+int TGAImage::get_bytespp() const{
+	return bytesPerPixel;
+}
+
+//Get the corner the data starts at
+TGAImage::Origin TGAImage::get_origin() const{
+	return Origin(origin);
+}
+
+//Reorder the data to start at another corner, the picture get() and set() see stays the same
+//Only the flips between the two origins are done, nothing moves if the origin is already right
+void TGAImage::set_origin(const Origin o){
+	if((origin ^ o) & TOP_LEFT) flip_vertically();
+	if((origin ^ o) & BOTTOM_RIGHT) flip_horizontally();
+	origin = o;
+}
+
+//Get the TGA Image data buffer, rows are in data order (see get_origin)
+//A mapped image is copied into its own memory first
+std::uint8_t* TGAImage::buffer(){
+	detach();
+	return data.data();
+}
+
+//Get the TGA Image data buffer, read only (a mapped image's pixels in place)
+const std::uint8_t* TGAImage::buffer() const{
+	return pixels();
+}
+
+//Pixels to read from, the mapped file's or the image's own
+const std::uint8_t* TGAImage::pixels() const{
+	return view ? view : data.data();
+}
+
+//Give a mapped image its own copy of the pixels before they are written to
+void TGAImage::detach(){
+	if(!view) return;
+	data.assign(view, view+size_t(width)*height*bytesPerPixel);
+	view = nullptr;
+	mapping.reset();
+}
+
+//Clear the data buffer, the memory is reused
+void TGAImage::clear(){
+	view = nullptr;
+	mapping.reset();
+	data.assign(width*height*bytesPerPixel, 0);
+}
+
+//Debugging Information
+void TGAImage::getInfo(){
+	std::cerr << "TGA size: " << width <<"x" << height << "\n";
+	std::cerr << "Pixels storage: " << bytesPerPixel << " bytes/pixel\n";
 }
\ No newline at end of file
@@ -0,0 +1,238 @@
+#include "Texture.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+//Pack a color as a little endian BGRA texel, grayscale is spread over the three channels and RGB gets an opaque alpha
+static std::uint32_t pack(const TGAColor& c){
+	std::uint8_t b = c.bgra[0], g = c.bgra[1], r = c.bgra[2], a = c.bgra[3];
+	if(c.bytesperpixel == 1) g = r = b;
+	if(c.bytesperpixel < 4) a = 255;
+	return std::uint32_t(b) | std::uint32_t(g) << 8 | std::uint32_t(r) << 16 | std::uint32_t(a) << 24;
+}
+
+//Position of x in [0,n) for repeating coordinates, the division is only paid outside the first repeat
+static inline int wrap(const int x, const int n){
+	if(unsigned(x) < unsigned(n)) return x;
+	int m = x % n;
+	return m < 0 ? m+n : m;
+}
+
+//Position of texel x,y of a level in texels_, both must be inside the level
+inline int Texture::index(const Level& level, const int x, const int y) const{
+	return base_ + level.offset + ((y/TEXTURE_TILE)*level.tilesX + x/TEXTURE_TILE)*TEXTURE_TILE*TEXTURE_TILE
+			+ (y%TEXTURE_TILE)*TEXTURE_TILE + x%TEXTURE_TILE;
+}
+
+//Texel x,y of a level
+inline std::uint32_t Texture::texel(const Level& level, const int x, const int y) const{
+	return texels_[index(level, x, y)];
+}
+
+//Empty texture
+Texture::Texture() : levels_(), texels_(), base_(0) {}
+
+//Copy an image into tiled storage and build its mip chain down to 1x1, each level a 2x2 box filter of the one above
+//Odd sizes round down, dropping the last row or column of the bigger level, a level 1 texel wide averages it twice
+Texture::Texture(const TGAImage& image) : levels_(), texels_(), base_(0) {
+	int w = image.get_width(), h = image.get_height();
+	if(w <= 0 || h <= 0) return;
+
+	int total = 0;
+	while(true){
+		Level level;
+		level.width = w;
+		level.height = h;
+		level.tilesX = (w+TEXTURE_TILE-1)/TEXTURE_TILE;
+		level.offset = total;
+		total += level.tilesX*((h+TEXTURE_TILE-1)/TEXTURE_TILE)*TEXTURE_TILE*TEXTURE_TILE;
+		levels_.push_back(level);
+		if(w == 1 && h == 1) break;
+		w = std::max(1, w/2);
+		h = std::max(1, h/2);
+	}
+
+	//Tiles are 64 bytes, start the storage on a cache line so every tile is exactly one
+	texels_.resize(total+15);
+	base_ = (16 - (reinterpret_cast<std::uintptr_t>(texels_.data()) & 63)/4) & 15;
+
+	const Level& top = levels_[0];
+	const int bpp = image.get_bytespp();
+	const std::uint8_t* pixels = image.buffer();
+	const bool fromTop = image.get_origin() & TGAImage::TOP_LEFT, fromRight = image.get_origin() & TGAImage::BOTTOM_RIGHT;
+	for(int y=0; y<top.height; y++){
+		//Row 0 is the image's top row (see TGAImage::get), wherever the image's data starts
+		const std::uint8_t* row = pixels + size_t(fromTop ? y : top.height-1-y)*top.width*bpp;
+		for(int x=0; x<top.width; x++)
+			texels_[index(top, x, y)] = pack(TGAColor(row+(fromRight ? top.width-1-x : x)*bpp, bpp));
+	}
+
+	for(int i=1; i<int(levels_.size()); i++){
+		const Level& src = levels_[i-1];
+		const Level& dst = levels_[i];
+		for(int y=0; y<dst.height; y++){
+			const int y0 = std::min(2*y, src.height-1), y1 = std::min(2*y+1, src.height-1);
+			for(int x=0; x<dst.width; x++){
+				const int x0 = std::min(2*x, src.width-1), x1 = std::min(2*x+1, src.width-1);
+				const std::uint32_t t[4] = {texel(src, x0, y0), texel(src, x1, y0), texel(src, x0, y1), texel(src, x1, y1)};
+				std::uint32_t average = 0;
+				for(int c=0; c<32; c+=8){
+					std::uint32_t sum = 2;
+					for(int k=0; k<4; k++) sum += (t[k] >> c) & 255;
+					average |= (sum/4) << c;
+				}
+				texels_[index(dst, x, y)] = average;
+			}
+		}
+	}
+}
+
+//Bilinear sample of a level, bgra receives the channels as floats in [0,255]
+void Texture::bilinear(const Level& level, const float u, const float v, float* bgra) const{
+	const float x = u*level.width-0.5f, y = v*level.height-0.5f;
+	const float fx = std::floor(x), fy = std::floor(y);
+	const float ax = x-fx, ay = y-fy;
+	const int x0 = wrap(int(fx), level.width), y0 = wrap(int(fy), level.height);
+	const int x1 = x0+1 == level.width ? 0 : x0+1, y1 = y0+1 == level.height ? 0 : y0+1;
+	const std::uint32_t t00 = texel(level, x0, y0), t10 = texel(level, x1, y0);
+	const std::uint32_t t01 = texel(level, x0, y1), t11 = texel(level, x1, y1);
+	for(int c=0; c<4; c++){
+		const int s = 8*c;
+		float top = ((t00 >> s) & 255) + (float((t10 >> s) & 255) - float((t00 >> s) & 255))*ax;
+		float bottom = ((t01 >> s) & 255) + (float((t11 >> s) & 255) - float((t01 >> s) & 255))*ax;
+		bgra[c] = top + (bottom-top)*ay;
+	}
+}
+
+//Is the texture without texels
+bool Texture::empty() const{
+	return levels_.empty();
+}
+
+//Get the width of the full resolution level
+int Texture::width() const{
+	return levels_.empty() ? 0 : levels_[0].width;
+}
+
+//Get the height of the full resolution level
+int Texture::height() const{
+	return levels_.empty() ? 0 : levels_[0].height;
+}
+
+//Get the number of mip levels, the last one is 1x1
+int Texture::nLevels() const{
+	return levels_.size();
+}
+
+//Mip level for a pixel from the screen derivatives of its texture coordinates (d/dx and d/dy of u and v)
+//log2 of the longer of the pixel's two sides measured in texels, below 0 the texture is magnified
+float Texture::lod(const float dudx, const float dvdx, const float dudy, const float dvdy) const{
+	if(levels_.empty()) return 0;
+	const float w = levels_[0].width, h = levels_[0].height;
+	const float lx = dudx*dudx*w*w + dvdx*dvdx*h*h;
+	const float ly = dudy*dudy*w*w + dvdy*dvdy*h*h;
+	return 0.5f*std::log2(std::max(std::max(lx, ly), 1e-20f));
+}
+
+//Trilinear sample: bilinear in the two levels around lod, blended by the fraction of lod
+//lod 0 or below is a bilinear sample of the full resolution level
+TGAColor Texture::sample(const float u, const float v, const float lod) const{
+	if(levels_.empty()) return TGAColor(0, 0, 0);
+
+	const float l = std::min(std::max(lod, 0.f), float(levels_.size()-1));
+	const int l0 = int(l);
+	const float t = l-l0;
+	float c[4];
+	bilinear(levels_[l0], u, v, c);
+	if(t > 0){
+		float c1[4];
+		bilinear(levels_[l0+1], u, v, c1);
+		for(int k=0; k<4; k++) c[k] += (c1[k]-c[k])*t;
+	}
+	return TGAColor(std::lrint(c[2]), std::lrint(c[1]), std::lrint(c[0]), std::lrint(c[3]));
+}
+
+#if defined(__SSE2__)
+//Texel channels as 4 floats
+static inline __m128 unpack(const std::uint32_t t){
+	const __m128i zero = _mm_setzero_si128();
+	return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(int(t)), zero), zero));
+}
+
+//Bilinear samples of one level for 4 fragments, coordinates and weights are worked out for all 4 at once
+//and each fragment's 4 channels are blended together
+static void bilinear4(const std::uint32_t* texels, const int width, const int height, const int tilesX,
+						const float* u, const float* v, __m128* colors){
+	const __m128 x = _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(u), _mm_set1_ps(float(width))), _mm_set1_ps(0.5f));
+	const __m128 y = _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(v), _mm_set1_ps(float(height))), _mm_set1_ps(0.5f));
+
+	//Floor: truncation rounds negative values up, take one off where it did
+	__m128i ix = _mm_cvttps_epi32(x), iy = _mm_cvttps_epi32(y);
+	ix = _mm_add_epi32(ix, _mm_castps_si128(_mm_cmplt_ps(x, _mm_cvtepi32_ps(ix))));
+	iy = _mm_add_epi32(iy, _mm_castps_si128(_mm_cmplt_ps(y, _mm_cvtepi32_ps(iy))));
+	const __m128 ax = _mm_sub_ps(x, _mm_cvtepi32_ps(ix)), ay = _mm_sub_ps(y, _mm_cvtepi32_ps(iy));
+
+	const __m128 one = _mm_set1_ps(1.f);
+	const __m128 bx = _mm_sub_ps(one, ax), by = _mm_sub_ps(one, ay);
+	float w00[4], w10[4], w01[4], w11[4];
+	_mm_storeu_ps(w00, _mm_mul_ps(bx, by));
+	_mm_storeu_ps(w10, _mm_mul_ps(ax, by));
+	_mm_storeu_ps(w01, _mm_mul_ps(bx, ay));
+	_mm_storeu_ps(w11, _mm_mul_ps(ax, ay));
+	int xs[4], ys[4];
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(xs), ix);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(ys), iy);
+
+	for(int i=0; i<4; i++){
+		const int x0 = wrap(xs[i], width), y0 = wrap(ys[i], height);
+		const int x1 = x0+1 == width ? 0 : x0+1, y1 = y0+1 == height ? 0 : y0+1;
+		const int r0 = (y0/TEXTURE_TILE)*tilesX, r1 = (y1/TEXTURE_TILE)*tilesX;
+		const int o0 = (y0%TEXTURE_TILE)*TEXTURE_TILE, o1 = (y1%TEXTURE_TILE)*TEXTURE_TILE;
+		const int c0 = x0/TEXTURE_TILE, c1 = x1/TEXTURE_TILE;
+		const int s0 = x0%TEXTURE_TILE, s1 = x1%TEXTURE_TILE;
+		const int tile = TEXTURE_TILE*TEXTURE_TILE;
+		__m128 c = _mm_mul_ps(unpack(texels[(r0+c0)*tile + o0 + s0]), _mm_set1_ps(w00[i]));
+		c = _mm_add_ps(c, _mm_mul_ps(unpack(texels[(r0+c1)*tile + o0 + s1]), _mm_set1_ps(w10[i])));
+		c = _mm_add_ps(c, _mm_mul_ps(unpack(texels[(r1+c0)*tile + o1 + s0]), _mm_set1_ps(w01[i])));
+		c = _mm_add_ps(c, _mm_mul_ps(unpack(texels[(r1+c1)*tile + o1 + s1]), _mm_set1_ps(w11[i])));
+		colors[i] = c;
+	}
+}
+#endif
+
+//Trilinear samples for 4 fragments sharing a level of detail (a block row of the rasterizer), out receives BGRA texels
+//Same result as 4 calls to sample() up to rounding
+void Texture::sample4(const float* u, const float* v, const float lod, std::uint32_t* out) const{
+	if(levels_.empty()){
+		std::fill(out, out+4, 0xff000000u);
+		return;
+	}
+
+#if defined(__SSE2__)
+	const float l = std::min(std::max(lod, 0.f), float(levels_.size()-1));
+	const int l0 = int(l);
+	const float t = l-l0;
+
+	__m128 c[4];
+	const Level& a = levels_[l0];
+	bilinear4(&texels_[base_+a.offset], a.width, a.height, a.tilesX, u, v, c);
+	if(t > 0){
+		__m128 c1[4];
+		const Level& b = levels_[l0+1];
+		bilinear4(&texels_[base_+b.offset], b.width, b.height, b.tilesX, u, v, c1);
+		const __m128 tt = _mm_set1_ps(t);
+		for(int i=0; i<4; i++) c[i] = _mm_add_ps(c[i], _mm_mul_ps(_mm_sub_ps(c1[i], c[i]), tt));
+	}
+
+	//Round and pack the 4 fragments' channels back to bytes
+	__m128i lo = _mm_packs_epi32(_mm_cvtps_epi32(c[0]), _mm_cvtps_epi32(c[1]));
+	__m128i hi = _mm_packs_epi32(_mm_cvtps_epi32(c[2]), _mm_cvtps_epi32(c[3]));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(lo, hi));
+#else
+	for(int i=0; i<4; i++) out[i] = pack(sample(u[i], v[i], lod));
+#endif
+}
\ No newline at end of file
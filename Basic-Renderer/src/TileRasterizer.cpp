@@ -0,0 +1,122 @@
+#include "TileRasterizer.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <thread>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+//Blocks of the tile target touched by the screen space box [min,max], false if the box misses the tile
+bool TileRasterizer::hizRange(const Vec3f& min, const Vec3f& max, const RenderTarget& target, int* range){
+	float x0 = std::max(min.x, float(target.x0)), x1 = std::min(max.x, float(target.x0+target.width-1));
+	float y0 = std::max(min.y, float(target.y0)), y1 = std::min(max.y, float(target.y0+target.height-1));
+	if(!(x0 <= x1 && y0 <= y1)) return false;
+	range[0] = (int(x0)-target.x0)/HIZ_BLOCK;
+	range[1] = (int(y0)-target.y0)/HIZ_BLOCK;
+	range[2] = (int(x1)-target.x0)/HIZ_BLOCK;
+	range[3] = (int(y1)-target.y0)/HIZ_BLOCK;
+	return true;
+}
+
+//Is depth z behind the farthest depth of every block in range, nothing at z or farther can pass the depth test there
+bool TileRasterizer::occluded(const float* hiz, const int* range, const float z){
+	for(int by=range[1]; by<=range[3]; by++)
+		for(int bx=range[0]; bx<=range[2]; bx++)
+			if(z < hiz[by*HIZ_BLOCKS+bx]) return false;
+	return true;
+}
+
+//Recompute the farthest depth of the blocks in range from the tile's depth buffer
+void TileRasterizer::updateHiZ(float* hiz, const float* depth, const int* range){
+	for(int by=range[1]; by<=range[3]; by++){
+		for(int bx=range[0]; bx<=range[2]; bx++){
+			const float* block = depth + by*HIZ_BLOCK*TILE_SIZE + bx*HIZ_BLOCK;
+#if defined(__SSE2__)
+			__m128 m = _mm_loadu_ps(block);
+			for(int y=0; y<HIZ_BLOCK; y++)
+				for(int x=0; x<HIZ_BLOCK; x+=4)
+					m = _mm_max_ps(m, _mm_loadu_ps(block+y*TILE_SIZE+x));
+			m = _mm_max_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1,0,3,2)));
+			m = _mm_max_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2,3,0,1)));
+			hiz[by*HIZ_BLOCKS+bx] = _mm_cvtss_f32(m);
+#else
+			float m = block[0];
+			for(int y=0; y<HIZ_BLOCK; y++)
+				for(int x=0; x<HIZ_BLOCK; x++)
+					m = std::max(m, block[y*TILE_SIZE+x]);
+			hiz[by*HIZ_BLOCKS+bx] = m;
+#endif
+		}
+	}
+}
+
+//Rasterizer for a width x height image, nThreads 0 uses every core
+//occlusion turns on skipping triangles and clusters hidden behind what a tile has drawn already
+TileRasterizer::TileRasterizer(const int width, const int height, const int nThreads, const bool occlusion) :
+			width_(width), height_(height), tilesX_((width+TILE_SIZE-1)/TILE_SIZE), tilesY_((height+TILE_SIZE-1)/TILE_SIZE),
+			nThreads_(nThreads > 0 ? nThreads : std::max(1u, std::thread::hardware_concurrency())), occlusion_(occlusion),
+			triangles_(), clusters_(), bins_(tilesX_*tilesY_), varyings_() {}
+
+//Start a cluster, triangles added from now on belong to it until the next call
+//min and max must bound every triangle of the cluster in screen space
+void TileRasterizer::beginCluster(const Vec3f& min, const Vec3f& max){
+	clusters_.push_back(Bounds{min, max});
+}
+
+//Queue a flat colored triangle (screen coordinates and depth)
+void TileRasterizer::add(const Vec3f* pts, const TGAColor& color){
+	push(pts, color, nullptr, 0);
+}
+
+//Queue a shaded triangle, varyings holds count floats per vertex laid out as triangle() expects them (1/w first)
+void TileRasterizer::add(const Vec3f* pts, const float* varyings, const int count){
+	push(pts, TGAColor(), varyings, count);
+}
+
+//Queue a triangle in every tile its bounding box touches, with its varyings if it has any
+void TileRasterizer::push(const Vec3f* pts, const TGAColor& color, const float* varyings, const int count){
+	float minX = std::min({pts[0].x, pts[1].x, pts[2].x});
+	float maxX = std::max({pts[0].x, pts[1].x, pts[2].x});
+	float minY = std::min({pts[0].y, pts[1].y, pts[2].y});
+	float maxY = std::max({pts[0].y, pts[1].y, pts[2].y});
+	if(!(maxX >= 0 && maxY >= 0 && minX < width_ && minY < height_)) return;		//Off screen (or NaN)
+
+	//Clamped to the image while still floats, converting a value out of int's range is undefined
+	int tx0 = int(std::max(minX, 0.f))/TILE_SIZE;
+	int ty0 = int(std::max(minY, 0.f))/TILE_SIZE;
+	int tx1 = int(std::min(maxX, float(width_-1)))/TILE_SIZE;
+	int ty1 = int(std::min(maxY, float(height_-1)))/TILE_SIZE;
+
+	const int index = triangles_.size();
+	int offset = -1;
+	if(varyings){
+		offset = varyings_.size();
+		varyings_.insert(varyings_.end(), varyings, varyings+3*count);
+	}
+	triangles_.push_back(Triangle{{pts[0], pts[1], pts[2]}, color, int(clusters_.size())-1, offset});
+	for(int ty=ty0; ty<=ty1; ty++)
+		for(int tx=tx0; tx<=tx1; tx++)
+			bins_[ty*tilesX_+tx].push_back(index);
+}
+
+//Draw every queued triangle into the image, which must be width x height
+//Pixels no triangle covers keep the image's color, shaded triangles need draw(image, shader)
+void TileRasterizer::draw(TGAImage& image) const{
+	drawAll(image, [](const Triangle& t, RenderTarget& target){ triangle(t.pts, t.color, target); });
+}
+
+//Forget every queued triangle, the tile grid is kept
+void TileRasterizer::clear(){
+	triangles_.clear();
+	clusters_.clear();
+	varyings_.clear();
+	for(std::vector<int>& bin : bins_) bin.clear();
+}
+
+//Get the number of queued triangles
+int TileRasterizer::nTriangles() const{
+	return triangles_.size();
+}
\ No newline at end of file
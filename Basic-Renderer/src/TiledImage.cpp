@@ -0,0 +1,209 @@
+#include "TiledImage.h"
+#include "StripeWriter.h"
+
+#include <cstring>
+#include <iostream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#define STRIPE_BYTES (16 << 20)				//Rows gathered for a write at a time, at least one
+
+//Width x height image of bpp bytes per pixel, black, in tileSize x tileSize tiles
+//With a backing file name the tiles are kept in that file (created, and removed with the image) and at most
+//maxResident of them are mapped at a time, otherwise they are kept in memory. Check good() before using the image
+TiledImage::TiledImage(const int width, const int height, const int bpp, const std::string& backing, const int maxResident,
+						const int tileSize) :
+			width_(width), height_(height), bytesPerPixel_(bpp), tileSize_(tileSize), tilesX_(0), tilesY_(0), tileBytes_(0),
+			maxResident_(std::max(1, maxResident)), tiles_(), lru_(), memory_(), path_(), fd_(-1) {
+	if(width <= 0 || height <= 0 || tileSize <= 0 || (bpp != TGAImage::GRAYSCALE && bpp != TGAImage::RGB && bpp != TGAImage::RGBA)){
+		std::cerr << "Can't make a " << width << "x" << height << " tiled image with " << bpp << " bytes per pixel\n";
+		width_ = height_ = 0;
+		return;
+	}
+	tilesX_ = (width+tileSize-1)/tileSize;
+	tilesY_ = (height+tileSize-1)/tileSize;
+	tileBytes_ = size_t(tileSize)*tileSize*bpp;
+	tiles_.assign(size_t(tilesX_)*tilesY_, Tile{nullptr, false, lru_.end()});
+	if(backing.empty()){
+		memory_.resize(tiles_.size());
+		return;
+	}
+
+#if defined(__unix__) || defined(__APPLE__)
+	//Tiles start on page boundaries so each one can be mapped on its own
+	const size_t page = sysconf(_SC_PAGESIZE);
+	tileBytes_ = (tileBytes_+page-1)/page*page;
+	fd_ = open(backing.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if(fd_ < 0 || ftruncate(fd_, off_t(tileBytes_)*tiles_.size()) != 0){
+		std::cerr << "Can't make the tile file " << backing << "\n";
+		if(fd_ >= 0){
+			close(fd_);
+			unlink(backing.c_str());
+		}
+		fd_ = -1;
+		width_ = height_ = 0;
+		return;
+	}
+	path_ = backing;
+#else
+	std::cerr << "Tiles can't be mapped from a file on this system, they are kept in memory\n";
+	memory_.resize(tiles_.size());
+#endif
+}
+
+//Unmap the tiles and remove the scratch file
+TiledImage::~TiledImage(){
+#if defined(__unix__) || defined(__APPLE__)
+	if(fd_ < 0) return;
+	for(int i : lru_) munmap(tiles_[i].pixels, tileBytes_);
+	close(fd_);
+	unlink(path_.c_str());
+#endif
+}
+
+//Unmap the least recently used tile, what was drawn stays in the file
+void TiledImage::evict(){
+#if defined(__unix__) || defined(__APPLE__)
+	const int i = lru_.back();
+	lru_.pop_back();
+	munmap(tiles_[i].pixels, tileBytes_);
+	tiles_[i].pixels = nullptr;
+	tiles_[i].lru = lru_.end();
+#endif
+}
+
+//Whether the image was made, see the constructor
+bool TiledImage::good() const{
+	return width_ > 0;
+}
+
+//Get the image width
+int TiledImage::get_width() const{
+	return width_;
+}
+
+//Get the image height
+int TiledImage::get_height() const{
+	return height_;
+}
+
+//Get the bytes per pixel
+int TiledImage::get_bytespp() const{
+	return bytesPerPixel_;
+}
+
+//Get the width and height of a tile in pixels
+int TiledImage::tileSize() const{
+	return tileSize_;
+}
+
+//Get the number of tiles along x
+int TiledImage::tilesX() const{
+	return tilesX_;
+}
+
+//Get the number of tiles along y
+int TiledImage::tilesY() const{
+	return tilesY_;
+}
+
+//Whether tile tx,ty was ever drawn into, tiles that weren't are black and take no memory
+bool TiledImage::used(const int tx, const int ty) const{
+	return tiles_[size_t(ty)*tilesX_+tx].used;
+}
+
+//Pixels of tile tx,ty: tileSize rows of tileSize pixels, the parts past the image's edges are unused
+//The tile is allocated or mapped if it has to be, null if that fails. With a file the pointer is valid until
+//maxResident other tiles have been asked for, in memory until the image is destroyed
+std::uint8_t* TiledImage::tile(const int tx, const int ty){
+	const int i = ty*tilesX_+tx;
+	Tile& t = tiles_[i];
+	if(fd_ < 0){
+		if(!t.pixels){
+			memory_[i].reset(new std::uint8_t[tileBytes_]());
+			t.pixels = memory_[i].get();
+			t.used = true;
+		}
+		return t.pixels;
+	}
+
+#if defined(__unix__) || defined(__APPLE__)
+	if(t.pixels){
+		lru_.splice(lru_.begin(), lru_, t.lru);
+		return t.pixels;
+	}
+	if(lru_.size() >= maxResident_) evict();
+	void* address = mmap(nullptr, tileBytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, off_t(tileBytes_)*i);
+	if(address == MAP_FAILED){
+		std::cerr << "Can't map tile " << tx << "," << ty << "\n";
+		return nullptr;
+	}
+	t.pixels = static_cast<std::uint8_t*>(address);
+	t.used = true;
+	lru_.push_front(i);
+	t.lru = lru_.begin();
+	return t.pixels;
+#else
+	return nullptr;
+#endif
+}
+
+//Get pixel color, pixels of unused tiles are black and stay unallocated
+TGAColor TiledImage::get(const int x, const int y){
+	if(x < 0 || y < 0 || x >= width_ || y >= height_ || !used(x/tileSize_, y/tileSize_)) return TGAColor();
+	const std::uint8_t* pixels = tile(x/tileSize_, y/tileSize_);
+	if(!pixels) return TGAColor();
+	return TGAColor(pixels + (size_t(y%tileSize_)*tileSize_ + x%tileSize_)*bytesPerPixel_, bytesPerPixel_);
+}
+
+//Set pixel color
+void TiledImage::set(const int x, const int y, const TGAColor& c){
+	if(x < 0 || y < 0 || x >= width_ || y >= height_) return;
+	std::uint8_t* pixels = tile(x/tileSize_, y/tileSize_);
+	if(pixels) memcpy(pixels + (size_t(y%tileSize_)*tileSize_ + x%tileSize_)*bytesPerPixel_, c.bgra, bytesPerPixel_);
+}
+
+//Copy n whole rows from row y to dst, width*bpp bytes a row, unused tiles give zeros
+bool TiledImage::readRows(const int y, const int n, std::uint8_t* dst){
+	if(y < 0 || n < 0 || y+n > height_) return false;
+	const size_t rowBytes = size_t(width_)*bytesPerPixel_;
+	const size_t tilePitch = size_t(tileSize_)*bytesPerPixel_;
+	for(int ty=y/tileSize_; ty*tileSize_ < y+n; ty++){
+		const int first = std::max(y, ty*tileSize_), last = std::min(y+n, (ty+1)*tileSize_);
+		for(int tx=0; tx<tilesX_; tx++){
+			const size_t bytes = size_t(std::min(tileSize_, width_-tx*tileSize_))*bytesPerPixel_;
+			std::uint8_t* out = dst + size_t(first-y)*rowBytes + tx*tilePitch;
+			const std::uint8_t* pixels = used(tx, ty) ? tile(tx, ty) : nullptr;
+			if(used(tx, ty) && !pixels) return false;
+			for(int row=first; row<last; row++, out+=rowBytes){
+				if(pixels) memcpy(out, pixels + (row-ty*tileSize_)*tilePitch, bytes);
+				else memset(out, 0, bytes);
+			}
+		}
+	}
+	return true;
+}
+
+//Write the image to a file in stripes of rows (see StripeWriter for the formats), only a stripe is held at a time
+//vflip writes the rows from the bottom up, as write_tga_file does for images drawn with y going up
+bool TiledImage::write(const std::string& filename, const bool vflip){
+	if(!good()) return false;
+	StripeWriter writer;
+	if(!writer.open(filename, width_, height_, bytesPerPixel_)) return false;
+
+	const size_t rowBytes = size_t(width_)*bytesPerPixel_;
+	const int stripe = int(std::max<size_t>(1, std::min<size_t>(tileSize_, STRIPE_BYTES/rowBytes)));
+	std::vector<std::uint8_t> rows(rowBytes*stripe);
+	for(int done=0; done<height_; done+=stripe){
+		const int n = std::min(stripe, height_-done);
+		const int y = vflip ? height_-done-n : done;
+		if(!readRows(y, n, rows.data())) return false;
+		const bool ok = vflip ? writer.write(rows.data() + (n-1)*rowBytes, n, -std::ptrdiff_t(rowBytes)) : writer.write(rows.data(), n, rowBytes);
+		if(!ok) return false;
+	}
+	return writer.close();
+}
\ No newline at end of file
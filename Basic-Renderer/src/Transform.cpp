@@ -0,0 +1,266 @@
+#include "Transform.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+static_assert(sizeof(Vec3f) == 3*sizeof(float), "Vec3f must be tightly packed to be loaded 4 floats at a time");
+static_assert(sizeof(Vec4f) == 4*sizeof(float), "Vec4f must be tightly packed to be stored 4 floats at a time");
+
+
+//Default constructor, identity mapping
+Viewport::Viewport() : scale(1), offset(0) {}
+
+//Constructor by value
+Viewport::Viewport(const Vec3f& _scale, const Vec3f& _offset) : scale(_scale), offset(_offset) {}
+
+//Maps [-1,1] onto the image, this is the mapping models used to be drawn with
+Viewport Viewport::unit(const int width, const int height){
+	return Viewport(Vec3f(width/2.f, height/2.f, -1), Vec3f(width/2.f, height/2.f, 1));
+}
+
+//Uniformly scales and centers the box [min,max] so it fills the image minus margin (fraction of the image) on each side
+//Depth is 0 at the front of the box and grows away from the viewer, who looks down the negative z axis
+Viewport Viewport::fit(const Vec3f& min, const Vec3f& max, const int width, const int height, const float margin){
+	Vec3f extent = max-min;
+	float largest = std::max(extent.x, extent.y);
+	float s = largest > 0 ? std::min(width, height)*(1-2*margin)/largest : 1;
+
+	Vec3f center = (min+max)*0.5f;
+	return Viewport(Vec3f(s, s, -s), Vec3f(width/2.f-center.x*s, height/2.f-center.y*s, max.z*s));
+}
+
+//Map a single point
+Vec3f Viewport::apply(const Vec3f& v) const{
+	return v*scale+offset;
+}
+
+//Clip space matrix giving the same screen positions as the viewport once divided by w and mapped to the image
+//Screen z is kept as is, it becomes the depth
+Mat4f Viewport::clip(const int width, const int height) const{
+	Mat4f r = Mat4f::identity();
+	r.m[0][0] = 2*scale.x/width;
+	r.m[0][3] = 2*offset.x/width-1;
+	r.m[1][1] = 2*scale.y/height;
+	r.m[1][3] = 2*offset.y/height-1;
+	r.m[2][2] = scale.z;
+	r.m[2][3] = offset.z;
+	return r;
+}
+
+//Get the number of vertices in the buffer
+int VertexBuffer::size() const{
+	return x.size();
+}
+
+//Resize every array of the buffer
+void VertexBuffer::resize(const int n){
+	x.resize(n);
+	y.resize(n);
+	z.resize(n);
+	ix.resize(n);
+	iy.resize(n);
+}
+
+//Axis aligned bounding box of a set of points
+void bounds(const std::vector<Vec3f>& verts, Vec3f& min, Vec3f& max){
+	min = max = Vec3f(0);
+	if(verts.empty()) return;
+
+	const int n = verts.size();
+	int i = 0;
+	min = max = verts[0];
+
+#if defined(__SSE2__)
+	//Every vertex but the last can be loaded as 4 floats, the 4th lane holds the next x and is ignored
+	const float* p = &verts[0].x;
+	__m128 lo = _mm_loadu_ps(p);
+	__m128 hi = lo;
+	for(; i<n-1; i++){
+		__m128 v = _mm_loadu_ps(p+3*i);
+		lo = _mm_min_ps(lo, v);
+		hi = _mm_max_ps(hi, v);
+	}
+	float l[4], h[4];
+	_mm_storeu_ps(l, lo);
+	_mm_storeu_ps(h, hi);
+	min = Vec3f(l[0], l[1], l[2]);
+	max = Vec3f(h[0], h[1], h[2]);
+#endif
+
+	for(; i<n; i++){
+		min = Vec3f(std::min(min.x, verts[i].x), std::min(min.y, verts[i].y), std::min(min.z, verts[i].z));
+		max = Vec3f(std::max(max.x, verts[i].x), std::max(max.y, verts[i].y), std::max(max.z, verts[i].z));
+	}
+}
+
+//Transform every vertex to screen space once, draw loops then index into the buffer instead of transforming per edge
+void transformVertices(const std::vector<Vec3f>& verts, const Viewport& view, VertexBuffer& out){
+	const int n = verts.size();
+	out.resize(n);
+	int i = 0;
+
+#if defined(__SSE2__)
+	const float* p = n ? &verts[0].x : nullptr;
+	const __m128 sx = _mm_set1_ps(view.scale.x), ox = _mm_set1_ps(view.offset.x);
+	const __m128 sy = _mm_set1_ps(view.scale.y), oy = _mm_set1_ps(view.offset.y);
+	const __m128 sz = _mm_set1_ps(view.scale.z), oz = _mm_set1_ps(view.offset.z);
+
+	for(; i+4<=n; i+=4, p+=12){
+		//4 vertices are 3 registers of xyzx yzxy zxyz, shuffle them into xxxx yyyy zzzz
+		__m128 a = _mm_loadu_ps(p);
+		__m128 b = _mm_loadu_ps(p+4);
+		__m128 c = _mm_loadu_ps(p+8);
+		__m128 bc = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1,0,0,2));
+		__m128 x = _mm_shuffle_ps(a, bc, _MM_SHUFFLE(3,0,3,0));
+		__m128 y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0,0,1,1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2,2,3,3)), _MM_SHUFFLE(2,0,2,0));
+		__m128 z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1,1,2,2)), c, _MM_SHUFFLE(3,0,2,0));
+
+		x = _mm_add_ps(_mm_mul_ps(x, sx), ox);
+		y = _mm_add_ps(_mm_mul_ps(y, sy), oy);
+		z = _mm_add_ps(_mm_mul_ps(z, sz), oz);
+
+		_mm_storeu_ps(&out.x[i], x);
+		_mm_storeu_ps(&out.y[i], y);
+		_mm_storeu_ps(&out.z[i], z);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&out.ix[i]), _mm_cvttps_epi32(x));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&out.iy[i]), _mm_cvttps_epi32(y));
+	}
+#endif
+
+	for(; i<n; i++){
+		Vec3f s = view.apply(verts[i]);
+		out.x[i] = s.x;
+		out.y[i] = s.y;
+		out.z[i] = s.z;
+		out.ix[i] = s.x;
+		out.iy[i] = s.y;
+	}
+}
+
+//Transform every vertex to clip space with the model to clip matrix mvp, then to a width x height image
+//Vertices are done 4 at a time: the matrix is applied to xxxx yyyy zzzz registers, clip positions are transposed back
+void projectVertices(const std::vector<Vec3f>& verts, const Mat4f& mvp, const int width, const int height, VertexBuffer& out){
+	const int n = verts.size();
+	out.resize(n);
+	out.clip.resize(n);
+	int i = 0;
+
+#if defined(__SSE2__)
+	const float* p = n ? &verts[0].x : nullptr;
+	__m128 m[4][4];
+	for(int r=0; r<4; r++)
+		for(int c=0; c<4; c++)
+			m[r][c] = _mm_set1_ps(mvp.m[r][c]);
+	const __m128 one = _mm_set1_ps(1);
+	const __m128 halfW = _mm_set1_ps(width/2.f), halfH = _mm_set1_ps(height/2.f);
+
+	for(; i+4<=n; i+=4, p+=12){
+		__m128 a = _mm_loadu_ps(p);
+		__m128 b = _mm_loadu_ps(p+4);
+		__m128 c = _mm_loadu_ps(p+8);
+		__m128 bc = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1,0,0,2));
+		__m128 x = _mm_shuffle_ps(a, bc, _MM_SHUFFLE(3,0,3,0));
+		__m128 y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0,0,1,1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2,2,3,3)), _MM_SHUFFLE(2,0,2,0));
+		__m128 z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1,1,2,2)), c, _MM_SHUFFLE(3,0,2,0));
+
+		__m128 row[4];
+		for(int r=0; r<4; r++)
+			row[r] = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m[r][0], x), _mm_mul_ps(m[r][1], y)), _mm_mul_ps(m[r][2], z)), m[r][3]);
+
+		//Perspective divide and viewport
+		__m128 invW = _mm_div_ps(one, row[3]);
+		__m128 sx = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(row[0], invW), one), halfW);
+		__m128 sy = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(row[1], invW), one), halfH);
+		__m128 sz = _mm_mul_ps(row[2], invW);
+		_mm_storeu_ps(&out.x[i], sx);
+		_mm_storeu_ps(&out.y[i], sy);
+		_mm_storeu_ps(&out.z[i], sz);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&out.ix[i]), _mm_cvttps_epi32(sx));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&out.iy[i]), _mm_cvttps_epi32(sy));
+
+		_MM_TRANSPOSE4_PS(row[0], row[1], row[2], row[3]);
+		for(int r=0; r<4; r++) _mm_storeu_ps(&out.clip[i+r].x, row[r]);
+	}
+#endif
+
+	for(; i<n; i++){
+		Vec4f c = mvp*Vec4f(verts[i], 1);
+		Vec3f s = toScreen(c, width, height);
+		out.clip[i] = c;
+		out.x[i] = s.x;
+		out.y[i] = s.y;
+		out.z[i] = s.z;
+		out.ix[i] = s.x;
+		out.iy[i] = s.y;
+	}
+}
+
+//Screen position of a clip space point in a width x height image, z/w becomes the depth
+Vec3f toScreen(const Vec4f& c, const int width, const int height){
+	float invW = 1/c.w;
+	return Vec3f((c.x*invW+1)*(width/2.f), (c.y*invW+1)*(height/2.f), c.z*invW);
+}
+
+//Signed distance of a clip space point to plane p of the clipping volume, positive inside
+//The planes are the near plane and a guard band of |x| <= guardX*w, |y| <= guardY*w
+static float planeDistance(const Vec4f& c, const int p, const float guardX, const float guardY){
+	switch(p){
+		case 0: return c.z+c.w;
+		case 1: return guardX*c.w-c.x;
+		case 2: return guardX*c.w+c.x;
+		case 3: return guardY*c.w-c.y;
+		default: return guardY*c.w+c.y;
+	}
+}
+
+//Clip a clip space polygon against the near plane and the guard band (Sutherland-Hodgman)
+//The guard band keeps projected points within reach of the rasterizer, guardX and guardY are in units of w (NDC)
+//Vertices are stride floats each: the clip position x,y,z,w followed by attributes, which are interpolated along
+//with the position so new vertices get matching attributes. out is empty if the polygon is entirely outside
+void clipPolygon(const std::vector<float>& in, std::vector<float>& out, const int stride, const float guardX, const float guardY){
+	std::vector<float> tmp;
+	out = in;
+	for(int p=0; p<5 && !out.empty(); p++){
+		tmp.swap(out);
+		out.clear();
+		const int n = tmp.size()/stride;
+		for(int i=0; i<n; i++){
+			const float* a = &tmp[i*stride];
+			const float* b = &tmp[((i+1)%n)*stride];
+			float da = planeDistance(Vec4f(a[0], a[1], a[2], a[3]), p, guardX, guardY);
+			float db = planeDistance(Vec4f(b[0], b[1], b[2], b[3]), p, guardX, guardY);
+			if(da >= 0) out.insert(out.end(), a, a+stride);
+			if((da >= 0) != (db >= 0)){
+				float t = da/(da-db);
+				for(int k=0; k<stride; k++) out.push_back(a[k] + (b[k]-a[k])*t);
+			}
+		}
+	}
+}
+
+//Clip a clip space segment against the near plane and the guard band (Liang-Barsky)
+//Returns false if nothing of it is left
+bool clipSegment(Vec4f& a, Vec4f& b, const float guardX, const float guardY){
+	float t0 = 0, t1 = 1;
+	for(int p=0; p<5; p++){
+		float da = planeDistance(a, p, guardX, guardY);
+		float db = planeDistance(b, p, guardX, guardY);
+		if(da < 0 && db < 0) return false;
+		if(da < 0) t0 = std::max(t0, da/(da-db));
+		else if(db < 0) t1 = std::min(t1, da/(da-db));
+	}
+	if(t0 > t1) return false;
+	Vec4f d = b-a;
+	b = a + d*t1;
+	a = a + d*t0;
+	return true;
+}
+
+//Is a clip space point inside the near plane and the guard band
+bool inGuardBand(const Vec4f& c, const float guardX, const float guardY){
+	return c.z >= -c.w && std::fabs(c.x) <= guardX*c.w && std::fabs(c.y) <= guardY*c.w;
+}
\ No newline at end of file
@@ -0,0 +1,202 @@
+#include "VertexCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+//Scoring constants from Tom Forsyth, "Linear-Speed Vertex Cache Optimisation"
+#define CACHE_DECAY_POWER 1.5f
+#define LAST_FACE_SCORE 0.75f
+#define VALENCE_BOOST_SCALE 2.0f
+#define VALENCE_BOOST_POWER 0.5f
+
+//Score of a vertex from its position in the simulated cache and the number of faces still waiting for it
+//Vertices of the face just added share a fixed score, older ones decay with their age in the cache
+//Vertices with few faces left get a boost so they are finished off and leave the cache for good
+static float vertexScore(const int cachePos, const int lastFaceSize, const int remaining, const int cacheSize){
+	if(remaining == 0) return -1;
+
+	float score = 0;
+	if(cachePos >= 0){
+		if(cachePos < lastFaceSize) score = LAST_FACE_SCORE;
+		else score = std::pow(1.f - float(cachePos-lastFaceSize)/(cacheSize-lastFaceSize), CACHE_DECAY_POWER);
+	}
+	return score + VALENCE_BOOST_SCALE*std::pow(float(remaining), -VALENCE_BOOST_POWER);
+}
+
+//Face and its score when it was queued, a score that no longer matches the face's means the entry is stale
+struct FaceScore {
+	float score;
+	int face;
+
+	bool operator<(const FaceScore& o) const { return score < o.score || (score == o.score && face > o.face); }	//Lowest index wins ties
+};
+
+//Reorder faces so consecutive faces reuse recently transformed vertices (Forsyth's greedy algorithm)
+//Faces are polygons, a polygon counts as one unit and pushes all of its vertices into the simulated LRU cache
+//Returns false and leaves the faces untouched if a face references a vertex outside [0,nVerts)
+//If faceOrder is given it receives the old index of every new face so per face data can follow
+bool optimizeFaceOrder(std::vector<std::vector<int>>& faces, const int nVerts, const int cacheSize, std::vector<int>* faceOrder){
+	const int nFaces = faces.size();
+
+	//Faces using each vertex, stored back to back
+	std::vector<int> remaining(nVerts, 0);
+	for(const std::vector<int>& f : faces){
+		for(int v : f){
+			if(v < 0 || v >= nVerts) return false;
+			remaining[v]++;
+		}
+	}
+	std::vector<int> adjStart(nVerts+1, 0);
+	for(int v=0; v<nVerts; v++) adjStart[v+1] = adjStart[v]+remaining[v];
+	std::vector<int> adjacency(adjStart[nVerts]);
+	std::vector<int> fill(adjStart.begin(), adjStart.end()-1);
+	for(int i=0; i<nFaces; i++)
+		for(int v : faces[i]) adjacency[fill[v]++] = i;
+
+	std::vector<int> cachePos(nVerts, -1);
+	std::vector<float> vScore(nVerts);
+	for(int v=0; v<nVerts; v++) vScore[v] = vertexScore(-1, 0, remaining[v], cacheSize);
+
+	std::vector<float> fScore(nFaces, 0);
+	std::vector<bool> added(nFaces, false);
+	for(int i=0; i<nFaces; i++)
+		for(int v : faces[i]) fScore[i] += vScore[v];
+
+	//Scores of the faces away from the cache, for when it runs dry: a face is queued again whenever one of its vertices
+	//leaves the cache, faces around the cache are rescored every step and only need the queue once they are left behind
+	std::priority_queue<FaceScore> dry;
+	for(int i=0; i<nFaces; i++) dry.push(FaceScore{fScore[i], i});
+
+	std::vector<int> order;
+	order.reserve(nFaces);
+	std::vector<int> cache, next, evicted;
+	cache.reserve(cacheSize+16);
+	next.reserve(cacheSize+16);
+
+	int best = -1;
+	while(int(order.size()) < nFaces){
+		if(best < 0){
+			//Nothing around the cache is left, start again from the best face that isn't added yet
+			while(added[dry.top().face] || dry.top().score != fScore[dry.top().face]) dry.pop();
+			best = dry.top().face;
+			dry.pop();
+		}
+
+		const std::vector<int>& face = faces[best];
+		added[best] = true;
+		order.push_back(best);
+
+		//New LRU cache: the face's vertices first, then the old cache without them
+		next.clear();
+		for(int v : face){
+			if(std::find(next.begin(), next.end(), v) == next.end()) next.push_back(v);
+			remaining[v]--;
+		}
+		const int lastFaceSize = next.size();
+		for(int v : cache)
+			if(std::find(next.begin(), next.begin()+lastFaceSize, v) == next.begin()+lastFaceSize) next.push_back(v);
+
+		//Vertices pushed out of the cache lose their cache score
+		evicted.clear();
+		for(size_t i=cacheSize; i<next.size(); i++){
+			cachePos[next[i]] = -1;
+			vScore[next[i]] = vertexScore(-1, 0, remaining[next[i]], cacheSize);
+			evicted.push_back(next[i]);
+		}
+		if(int(next.size()) > cacheSize) next.resize(cacheSize);
+		cache.swap(next);
+
+		for(int i=0; i<int(cache.size()); i++){
+			cachePos[cache[i]] = i;
+			vScore[cache[i]] = vertexScore(i, lastFaceSize, remaining[cache[i]], cacheSize);
+		}
+
+		//Rescore the faces around the cache and pick the best one
+		best = -1;
+		float bestScore = -1;
+		for(int v : cache){
+			for(int a=adjStart[v]; a<adjStart[v+1]; a++){
+				int f = adjacency[a];
+				if(added[f]) continue;
+				float score = 0;
+				for(int w : faces[f]) score += vScore[w];
+				fScore[f] = score;
+				if(score > bestScore){
+					bestScore = score;
+					best = f;
+				}
+			}
+		}
+
+		//Faces of the evicted vertices are queued with their new scores
+		for(int v : evicted){
+			for(int a=adjStart[v]; a<adjStart[v+1]; a++){
+				int f = adjacency[a];
+				if(added[f]) continue;
+				float score = 0;
+				for(int w : faces[f]) score += vScore[w];
+				fScore[f] = score;
+				dry.push(FaceScore{score, f});
+			}
+		}
+	}
+
+	std::vector<std::vector<int>> reordered(nFaces);
+	for(int i=0; i<nFaces; i++) reordered[i].swap(faces[order[i]]);
+	faces.swap(reordered);
+	if(faceOrder) faceOrder->swap(order);
+	return true;
+}
+
+//Renumber vertices in the order the faces first use them so vertex fetches walk memory forward
+//Vertices no face uses are moved to the end, in their old order
+//Returns the old index of every new vertex so other per vertex data can be reordered the same way
+std::vector<int> renumberVertices(std::vector<Vec3f>& vertices, std::vector<std::vector<int>>& faces){
+	const int nVerts = vertices.size();
+	std::vector<int> remap(nVerts, -1);
+	std::vector<int> order;
+	order.reserve(nVerts);
+
+	for(std::vector<int>& f : faces){
+		for(int& v : f){
+			if(v < 0 || v >= nVerts) continue;
+			if(remap[v] < 0){
+				remap[v] = order.size();
+				order.push_back(v);
+			}
+			v = remap[v];
+		}
+	}
+	for(int v=0; v<nVerts; v++){
+		if(remap[v] < 0){
+			remap[v] = order.size();
+			order.push_back(v);
+		}
+	}
+
+	std::vector<Vec3f> reordered(nVerts);
+	for(int i=0; i<nVerts; i++) reordered[i] = vertices[order[i]];
+	vertices.swap(reordered);
+	return order;
+}
+
+//Average number of vertex cache misses per triangle for a FIFO cache of cacheSize entries (ACMR)
+//Polygons count as their fan triangles, 0.5 is the best a large regular triangle mesh can reach and 3 the worst
+float cacheMissRatio(const std::vector<std::vector<int>>& faces, const int nVerts, const int cacheSize){
+	std::vector<int> stamp(nVerts, -cacheSize);		//Miss count when each vertex entered the cache
+	int time = 0;
+	long misses = 0, triangles = 0;
+
+	for(const std::vector<int>& f : faces){
+		for(int v : f){
+			if(v < 0 || v >= nVerts) continue;
+			if(time-stamp[v] >= cacheSize){			//FIFO: a vertex is evicted cacheSize misses after it came in
+				stamp[v] = time++;
+				misses++;
+			}
+		}
+		if(f.size() > 2) triangles += f.size()-2;
+	}
+	return triangles ? float(misses)/triangles : 0;
+}
\ No newline at end of file
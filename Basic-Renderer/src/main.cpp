@@ -1,17 +1,293 @@
-#include "Model.h"
-#include "Bresenham.h"
-
-int main(int argc, char** argv){
-
-	Model *model = NULL;
-	if(argc==2){
-		model = new Model(argv[1]);
-	}else{
-		model = new Model("./obj/CoronaCap.obj");
-	}
-
-	Bresenham(model);
-
-	delete model;
-	return 0;
+#include "Model.h"
+#include "Bresenham.h"
+#include "Rasterize.h"
+#include "Cull.h"
+#include "Simplify.h"
+#include "Camera.h"
+#include "FrameWriter.h"
+#include "ShadowMap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <iostream>
+
+//Read up to n comma separated numbers, returns how many were read
+static int parseFloats(char* text, float* values, const int n){
+	int count = 0;
+	for(char* t = strtok(text, ","); t && count<n; t = strtok(NULL, ","))
+		values[count++] = atof(t);
+	return count;
+}
+
+//Fill a model with a shader, wrapped in Shadowed if there is a shadow map
+template<class S, int N>
+static void fillModel(const Model* model, const Shader<S, N>& shader, const ShadowMap* shadow, const int pcf, const Mat4f& mvp,
+						TGAImage& image, const int threads, const int cull){
+	if(shadow) Rasterize(model, Shadowed<S>(shader.derived(), model, shadow, pcf), mvp, image, threads, cull);
+	else Rasterize(model, shader, mvp, image, threads, cull);
+}
+
+int main(int argc, char** argv){
+
+	const char* filename = "./obj/CoronaCap.obj";
+	int edgeFilter = EdgeList::ALL;
+	float featureAngle = 30;
+	bool stream = false;
+	int size = 1000;
+	bool lod = false;
+	std::vector<int> lodTargets;
+	bool fit = true;
+	bool optimize = false;
+	const char* objOutput = NULL;
+	bool fill = false;
+	int threads = 0;
+	int cull = CULL_FRUSTUM | CULL_OCCLUSION;
+	bool camera = false;
+	float orbit[3] = {0, 0, 1};					//Yaw, pitch (degrees) and distance
+	float fov = 40;
+	float eye[3], target[3];
+	bool haveEye = false, haveTarget = false;
+	const char* shading = "flat";
+	const char* textureFile = NULL;
+	int frames = 0;
+	bool shadows = false;
+	int pcf = 1;
+	float lightDir[3];
+	bool haveLight = false;
+	int shadowSize = 0;
+	bool qoi = false;
+	int posterWidth = 0, posterHeight = 0;
+
+	//Usage: runner [--feature angle] [--silhouette] [--stream] [--size pixels] [--lod] [--lod-targets n,n,..] [--unit] [--optimize] [--write-obj file] [--fill] [--threads n] [--backface] [--no-cull]
+	//              [--orbit yaw,pitch[,distance]] [--eye x,y,z] [--target x,y,z] [--fov degrees] [--shade flat|gouraud|phong|texture] [--texture file.tga] [--frames n]
+	//              [--shadows] [--pcf radius] [--light x,y,z] [--shadow-size texels] [--qoi] [--poster WxH] [model.obj]
+	for(int i=1; i<argc; i++){
+		if(!strcmp(argv[i], "--feature") && i+1<argc){
+			edgeFilter |= EdgeList::FEATURE;			//Only draw edges sharper than the angle (degrees)
+			featureAngle = atof(argv[++i]);
+		}else if(!strcmp(argv[i], "--silhouette")){
+			edgeFilter |= EdgeList::SILHOUETTE;			//Only draw the outline as seen from the front
+		}else if(!strcmp(argv[i], "--stream")){
+			stream = true;								//Draw while reading, for meshes that don't fit in memory
+		}else if(!strcmp(argv[i], "--size") && i+1<argc){
+			size = atoi(argv[++i]);						//Width and height of the output image
+		}else if(!strcmp(argv[i], "--lod")){
+			lod = true;									//Draw a simplified model when the image is too small for the detail
+		}else if(!strcmp(argv[i], "--lod-targets") && i+1<argc){
+			lod = true;									//Face counts of the simplified levels, comma separated
+			for(char* t = strtok(argv[++i], ","); t; t = strtok(NULL, ","))
+				lodTargets.push_back(atoi(t));
+		}else if(!strcmp(argv[i], "--unit")){
+			fit = false;								//Map [-1,1] onto the image instead of framing the model
+		}else if(!strcmp(argv[i], "--optimize")){
+			optimize = true;							//Reorder faces and vertices for cache locality after loading
+		}else if(!strcmp(argv[i], "--write-obj") && i+1<argc){
+			objOutput = argv[++i];						//Save the model drawn (optimized, or the --lod level picked) so the work is done once
+		}else if(!strcmp(argv[i], "--fill")){
+			fill = true;								//Draw shaded solid faces instead of the wireframe
+		}else if(!strcmp(argv[i], "--threads") && i+1<argc){
+			threads = atoi(argv[++i]);					//Worker threads, 0 (default) uses every core
+		}else if(!strcmp(argv[i], "--backface")){
+			cull |= CULL_BACK;							//Skip faces turned away, for closed meshes with consistent windings
+		}else if(!strcmp(argv[i], "--no-cull")){
+			cull = CULL_NONE;							//Hand every face to the rasterizer
+		}else if(!strcmp(argv[i], "--orbit") && i+1<argc){
+			camera = true;								//Perspective camera circling the model
+			parseFloats(argv[++i], orbit, 3);
+		}else if(!strcmp(argv[i], "--eye") && i+1<argc){
+			camera = haveEye = true;					//Perspective camera at a point, looking at --target or the model's center
+			if(parseFloats(argv[++i], eye, 3) != 3){
+				std::cerr << "--eye needs a point x,y,z\n";
+				return 1;
+			}
+		}else if(!strcmp(argv[i], "--target") && i+1<argc){
+			camera = haveTarget = true;
+			if(parseFloats(argv[++i], target, 3) != 3){
+				std::cerr << "--target needs a point x,y,z\n";
+				return 1;
+			}
+		}else if(!strcmp(argv[i], "--fov") && i+1<argc){
+			camera = true;								//Vertical field of view, 0 for an orthographic camera
+			fov = atof(argv[++i]);
+		}else if(!strcmp(argv[i], "--shade") && i+1<argc){
+			fill = true;								//Shading of filled faces, flat (default), gouraud, phong or texture
+			shading = argv[++i];
+		}else if(!strcmp(argv[i], "--texture") && i+1<argc){
+			fill = true;								//Texture image for --shade texture
+			shading = "texture";
+			textureFile = argv[++i];
+		}else if(!strcmp(argv[i], "--frames") && i+1<argc){
+			camera = true;								//Turntable: n views all around the model, saved as output_0000.tga, output_0001.tga, ..
+			frames = atoi(argv[++i]);
+		}else if(!strcmp(argv[i], "--shadows")){
+			fill = shadows = true;						//Shadow map pass from the light before the fill
+		}else if(!strcmp(argv[i], "--pcf") && i+1<argc){
+			pcf = atoi(argv[++i]);						//Shadow edge softening radius in shadow map texels, 0 for hard edges
+		}else if(!strcmp(argv[i], "--light") && i+1<argc){
+			haveLight = true;							//Direction towards the light in model space, default is from the viewer
+			//(from above and to the left with --shadows, which the viewer's light can't cast)
+			const int n = parseFloats(argv[++i], lightDir, 3);
+			if(n != 3 || !(lightDir[0]*lightDir[0] + lightDir[1]*lightDir[1] + lightDir[2]*lightDir[2] > 0)){
+				std::cerr << "--light needs a non zero direction x,y,z\n";
+				return 1;
+			}
+		}else if(!strcmp(argv[i], "--shadow-size") && i+1<argc){
+			shadowSize = atoi(argv[++i]);				//Shadow map width and height, the image size within [1024,4096] by default
+		}else if(!strcmp(argv[i], "--qoi")){
+			qoi = true;									//Save renders as QOI (much smaller than TGA RLE) instead of TGA
+		}else if(!strcmp(argv[i], "--poster") && i+1<argc){
+			//Wireframe of any size, drawn into tiles kept in a scratch file: memory stays bounded
+			if(sscanf(argv[++i], "%dx%d", &posterWidth, &posterHeight) != 2 || posterWidth <= 0 || posterHeight <= 0)
+				posterWidth = posterHeight = 0;
+		}else{
+			filename = argv[i];
+		}
+	}
+
+	if(stream){
+		streamBresenham(filename, size, size, fit, qoi);
+		return 0;
+	}
+
+	Model *model = new Model(filename);
+	if(optimize) model->optimize();
+
+	Viewport view = fit ? Viewport::fit(model->bboxMin(), model->bboxMax(), size, size) : Viewport::unit(size, size);
+
+	//The level of detail is picked for the framed view, a camera that frames the model differently is close enough
+	//Only the levels down to the one the view needs are built, the picked level can be saved with --write-obj and drawn
+	//from that file next time instead of simplifying the full model again
+	LODChain* chain = NULL;
+	const Model* drawn = model;
+	if(lod){
+		chain = new LODChain(model, lodTargets.empty() ? LODChain::defaultTargets(model) : lodTargets,
+								LODChain::wantedFaces(model, view, size, size));
+		drawn = chain->select(view, size, size);
+	}
+	if(objOutput) drawn->write_obj_file(objOutput);
+
+	//Camera turned by an angle (degrees) around the vertical axis through the model's center
+	auto makeCamera = [&](const float turn){
+		Camera cam = Camera::orbit(model->bboxMin(), model->bboxMax(), orbit[0]+turn, orbit[1], fov, orbit[2]);
+		if(haveEye || haveTarget){
+			Vec3f center = (model->bboxMin()+model->bboxMax())*0.5f;
+			float radius = (model->bboxMax()-model->bboxMin()).length()*0.5f;
+			if(haveEye) cam.eye = Vec3f(eye[0], eye[1], eye[2]);
+			if(haveEye && turn != 0){
+				Vec3f offset = cam.eye-center;
+				float c = std::cos(turn*0.017453292519943295f), s = std::sin(turn*0.017453292519943295f);
+				cam.eye = center + Vec3f(offset.x*c + offset.z*s, offset.y, offset.z*c - offset.x*s);
+			}
+			cam.target = haveTarget ? Vec3f(target[0], target[1], target[2]) : center;
+			cam.zNear = radius*0.01f;
+			cam.zFar = (cam.eye-center).length()+radius;
+		}
+		return cam;
+	};
+
+	//The texture is tiled and mipmapped once, straight from the file when it is uncompressed, the image isn't needed after that
+	Texture texture;
+	if(fill && !strcmp(shading, "texture")){
+		TGAImage image;
+		if(textureFile && image.map_tga_file(textureFile)) texture = Texture(image);
+		if(texture.empty()){
+			std::cerr << "--shade texture needs a readable --texture image\n";
+			shading = "gouraud";
+		}
+	}
+
+	//Shadow maps grow with the square of their size, and can't go past SHADOW_MAX_SIZE
+	if(shadowSize <= 0) shadowSize = std::min(std::max(size, 1024), 4096);
+	if(shadowSize > SHADOW_MAX_SIZE){
+		std::cerr << "Shadow maps are at most " << SHADOW_MAX_SIZE << " texels wide, using " << SHADOW_MAX_SIZE << "\n";
+		shadowSize = SHADOW_MAX_SIZE;
+	}
+	//A negative filter radius would look at no texel and leave everything in shadow, a large one costs (2*pcf+1)^2 lookups
+	if(pcf < 0 || pcf > SHADOW_MAX_PCF){
+		std::cerr << "--pcf takes a radius within [0," << SHADOW_MAX_PCF << "], using " << std::min(std::max(pcf, 0), SHADOW_MAX_PCF) << "\n";
+		pcf = std::min(std::max(pcf, 0), SHADOW_MAX_PCF);
+	}
+	ShadowMap* fixedShadow = NULL;
+	if(shadows && haveLight){
+		Vec3f light(lightDir[0], lightDir[1], lightDir[2]);
+		fixedShadow = new ShadowMap(drawn, light.normalize(), shadowSize);
+	}
+
+	//Draws one view into an image, dir is the direction the viewer looks in and up its up vector
+	//Fills are lit from the light, the wireframe's view direction points into the scene
+	EdgeList* edges = (camera && !fill) ? new EdgeList(drawn) : NULL;
+	auto render = [&](const Mat4f& mvp, const Vec3f& dir, const Vec3f& up, TGAImage& image){
+		if(!fill){
+			Bresenham(drawn, *edges, mvp, dir, image, edgeFilter, featureAngle, threads);
+			return;
+		}
+
+		const Vec3f toViewer = -dir;
+		Vec3f light = toViewer;
+		if(haveLight){
+			light = Vec3f(lightDir[0], lightDir[1], lightDir[2]);
+			light.normalize();
+		}else if(shadows){
+			Vec3f right = dir.cross(up).normalize();
+			Vec3f above = right.cross(dir);
+			light = (toViewer + above*0.8f - right*0.6f).normalize();
+		}
+
+		//One depth pass from the light per view when it moves with the viewer, a given light's map is made once
+		ShadowMap* shadow = fixedShadow ? fixedShadow : shadows ? new ShadowMap(drawn, light, shadowSize) : NULL;
+		if(!strcmp(shading, "gouraud")){
+			fillModel(drawn, GouraudShader(drawn, light), shadow, pcf, mvp, image, threads, cull);
+		}else if(!strcmp(shading, "phong")){
+			fillModel(drawn, PhongShader(drawn, light, toViewer), shadow, pcf, mvp, image, threads, cull);
+		}else if(!strcmp(shading, "texture")){
+			fillModel(drawn, TextureShader(drawn, &texture, light), shadow, pcf, mvp, image, threads, cull);
+		}else{
+			fillModel(drawn, FlatShader(drawn, light), shadow, pcf, mvp, image, threads, cull);
+		}
+		if(shadow != fixedShadow) delete shadow;
+	};
+
+	if(posterWidth > 0){
+		//TGA stops at 65535 pixels a side, larger posters are saved as PPM unless QOI is asked for
+		if(fill || camera) std::cerr << "--poster draws the framed wireframe, fills and cameras are ignored\n";
+		Viewport posterView = fit ? Viewport::fit(model->bboxMin(), model->bboxMax(), posterWidth, posterHeight) : Viewport::unit(posterWidth, posterHeight);
+		TiledImage poster(posterWidth, posterHeight, TGAImage::RGB, "output.tiles");
+		if(poster.good()){
+			drawSegments(wireframeSegments(drawn, posterView, edgeFilter, featureAngle), poster, TGAColor(255, 255, 255));
+			poster.write(qoi ? "output.qoi" : (posterWidth > 0xFFFF || posterHeight > 0xFFFF) ? "output.ppm" : "output.tga");
+		}
+	}else if(frames > 0){
+		//The model is loaded once, frame i+1 renders while frame i is encoded and written
+		FrameWriter writer(size, size);
+		char name[32];
+		for(int i=0; i<frames; i++){
+			Camera cam = makeCamera(360.f*i/frames);
+			int frame = writer.acquire();
+			render(cam.matrix(size, size), cam.direction(), cam.up, writer.frame(frame));
+			snprintf(name, sizeof(name), qoi ? "output_%04d.qoi" : "output_%04d.tga", i);
+			writer.submit(frame, name);
+		}
+		if(writer.finish()) std::cerr << "Some frames couldn't be written\n";
+	}else{
+		TGAImage image(size, size, TGAImage::RGB);
+		if(!camera && !fill){
+			drawSegments(wireframeSegments(drawn, view, edgeFilter, featureAngle), image, TGAColor(255, 255, 255), threads);
+		}else if(camera){
+			Camera cam = makeCamera(0);
+			render(cam.matrix(size, size), cam.direction(), cam.up, image);
+		}else{
+			render(view.clip(size, size), Vec3f(0, 0, -1), Vec3f(0, 1, 0), image);
+		}
+		if(qoi) image.write_qoi_file("output.qoi");
+		else image.write_tga_file("output.tga");
+	}
+
+	delete fixedShadow;
+	delete edges;
+	delete chain;
+	delete model;
+	return 0;
 }
\ No newline at end of file
@@ -1,72 +1,232 @@
-#include "Model.h"
-
-#include <iostream> //std::cerr
-#include <sstream> //std::istringstream
-#include <fstream> //std::ifstream
-#include <string> //std::c_str
-
-
-//Constructor
-Model::Model(const char *filename) : vertices_(), faces_() {
-	std::ifstream in;
-	
-	//Open the OBJ file
-	in.open(filename, std::ifstream::in);
-	if(in.fail()) return;
-
-	std::string line;
-	while(!in.eof()){
-		std::getline(in, line);					//Get a single line from the input stream and read into string line
-		std::istringstream iss(line.c_str());	//Construct input stream from line to parse values (converts line to a C style string first)
-		char trash;								//Placeholder for reading values not needed
-		if(!line.compare(0, 2, "v ")){			//Compare the first two characters (is it a vertex?)
-			iss >> trash;						//Trash data type indicator(vertex)
-			//Read in a vector
-			Vec3f v;
-			iss >> v.x >> v.y >> v.z;
-			vertices_.push_back(v);
-		}else if(!line.compare(0, 2, "f ")){	//Is it a face?
-			std::vector<int> f;
-			iss>>trash;							//Trash the data type indicator(face)
-			int valTrash;						//TODO: Read in texture coordinates and normals (for now trash the vals)
-			int idx;						//Trash the slash character delimeters
-
-			//Format "vertexIdx/vertexTextureIdx/vertexNormalIdx ../../.. ../../.."
-			while(iss >> idx >> trash >> valTrash >> trash >> valTrash){
-				//Note each input stream has 3 vertices so this loop executes 3 times
-				idx--;				//Wavefront obj indexing starts at 1
-				f.push_back(idx);
-			}
-
-			faces_.push_back(f);
-
-		}	
-
-	}
-
-}
-
-//Get the vertex count
-int Model::nVerts() const{
-	return vertices_.size();
-}
-
-
-//Get the face count
-int Model::nFaces() const{
-	return faces_.size();
-}
-
-//Get a vertex at index idx
-Vec3f Model::vert(int idx) const{
-	return vertices_[idx];
-}
-
-//Get a face at index idx
-std::vector<int> Model::face(int idx) const{
-	return faces_[idx];
-}
-
-void Model::debug(){
-	std::cerr << "#v: " << nVerts() << " #f " << nFaces() << "\n";
+#include "Model.h"
+#include "Transform.h"
+#include "VertexCache.h"
+
+#include <iostream> //std::cerr
+#include <sstream> //std::istringstream
+#include <fstream> //std::ifstream
+#include <string> //std::c_str
+#include <cstdlib> //std::atoi
+
+
+//Constructor
+Model::Model(const char *filename) : vertices_(), faces_(), bboxMin_(), bboxMax_() {
+	std::ifstream in;
+	
+	//Open the OBJ file
+	in.open(filename, std::ifstream::in);
+	if(in.fail()) return;
+
+	std::string line;
+	while(!in.eof()){
+		std::getline(in, line);					//Get a single line from the input stream and read into string line
+		std::istringstream iss(line.c_str());	//Construct input stream from line to parse values (converts line to a C style string first)
+		char trash;								//Placeholder for reading values not needed
+		if(!line.compare(0, 2, "v ")){			//Compare the first two characters (is it a vertex?)
+			iss >> trash;						//Trash data type indicator(vertex)
+			//Read in a vector
+			Vec3f v;
+			iss >> v.x >> v.y >> v.z;
+			vertices_.push_back(v);
+		}else if(!line.compare(0, 3, "vt ")){	//Texture coordinate
+			iss >> trash >> trash;
+			float u = 0, v = 0;
+			iss >> u >> v;
+			uvs_.push_back(Vec2f(u, v));
+		}else if(!line.compare(0, 3, "vn ")){	//Vertex normal
+			iss >> trash >> trash;
+			Vec3f n;
+			iss >> n.x >> n.y >> n.z;
+			normals_.push_back(n);
+		}else if(!line.compare(0, 2, "f ")){	//Is it a face?
+			std::vector<int> f, ft, fn;
+			iss>>trash;							//Trash the data type indicator(face)
+			std::string vertex;
+
+			//Format "vertexIdx/vertexTextureIdx/vertexNormalIdx ../../.. ../../..", the texture and normal indices are optional
+			while(iss >> vertex){
+				int idx = std::atoi(vertex.c_str());	//Stops at the first slash
+				if(!idx) break;
+				idx = idx > 0 ? idx-1 : int(vertices_.size())+idx;	//Wavefront obj indexing starts at 1, negative values count back
+				f.push_back(idx);
+
+				int t = 0, n = 0;
+				size_t slash = vertex.find('/');
+				if(slash != std::string::npos){
+					t = std::atoi(vertex.c_str()+slash+1);			//0 if empty ("v//vn")
+					slash = vertex.find('/', slash+1);
+					if(slash != std::string::npos) n = std::atoi(vertex.c_str()+slash+1);
+				}
+				ft.push_back(t > 0 ? t-1 : t < 0 ? int(uvs_.size())+t : -1);
+				fn.push_back(n > 0 ? n-1 : n < 0 ? int(normals_.size())+n : -1);
+			}
+
+			faces_.push_back(f);
+			faceUVs_.push_back(ft);
+			faceNormals_.push_back(fn);
+		}	
+
+	}
+
+	bounds(vertices_, bboxMin_, bboxMax_);
+	computeNormals();
+}
+
+//Constructor from vertices and faces that are already in memory (used for generated meshes)
+Model::Model(const std::vector<Vec3f>& vertices, const std::vector<std::vector<int>>& faces) : vertices_(vertices), faces_(faces), bboxMin_(), bboxMax_() {
+	for(const std::vector<int>& f : faces_){
+		faceUVs_.push_back(std::vector<int>(f.size(), -1));
+		faceNormals_.push_back(std::vector<int>(f.size(), -1));
+	}
+	bounds(vertices_, bboxMin_, bboxMax_);
+	computeNormals();
+}
+
+//Give face corners without a valid normal a smooth one: the area weighted average of the normals of the faces around
+//the vertex (Newell's method), stored after the file's normals
+void Model::computeNormals(){
+	bool missing = false;
+	for(const std::vector<int>& fn : faceNormals_)
+		for(int n : fn) missing = missing || n < 0 || n >= int(normals_.size());
+	if(!missing) return;
+
+	const int base = normals_.size();
+	normals_.resize(base+vertices_.size(), Vec3f(0));
+	for(const std::vector<int>& f : faces_){
+		const int n = f.size();
+		Vec3f normal;
+		for(int j=0; j<n; j++){
+			Vec3f a = vertices_[f[j]];
+			Vec3f b = vertices_[f[(j+1)%n]];
+			normal += Vec3f((a.y-b.y)*(a.z+b.z), (a.z-b.z)*(a.x+b.x), (a.x-b.x)*(a.y+b.y));
+		}
+		for(int v : f) normals_[base+v] += normal;
+	}
+	for(int i=base; i<int(normals_.size()); i++) normals_[i].normalize();
+
+	for(int i=0; i<int(faces_.size()); i++)
+		for(int j=0; j<int(faces_[i].size()); j++)
+			if(faceNormals_[i][j] < 0 || faceNormals_[i][j] >= base) faceNormals_[i][j] = base+faces_[i][j];
+}
+
+//Get the vertex count
+int Model::nVerts() const{
+	return vertices_.size();
+}
+
+
+//Get the face count
+int Model::nFaces() const{
+	return faces_.size();
+}
+
+//Get a vertex at index idx
+Vec3f Model::vert(int idx) const{
+	return vertices_[idx];
+}
+
+//Get a face at index idx
+std::vector<int> Model::face(int idx) const{
+	return faces_[idx];
+}
+
+//Reorder faces for vertex cache reuse, then renumber vertices in the order the faces use them
+//Afterwards consecutive faces share vertices and vertex fetches walk forward through memory
+//Files that are already in a good order (CoronaCap is close to strips) keep their face order if the reordering doesn't beat it
+void Model::optimize(){
+	std::vector<std::vector<int>> reordered(faces_);
+	std::vector<int> order;
+	if(optimizeFaceOrder(reordered, vertices_.size(), 32, &order) && cacheMissRatio(reordered, vertices_.size()) < cacheMissRatio(faces_, vertices_.size())){
+		faces_.swap(reordered);
+		//Texture coordinate and normal indices follow their faces
+		std::vector<std::vector<int>> uvs(order.size()), normals(order.size());
+		for(int i=0; i<int(order.size()); i++){
+			uvs[i].swap(faceUVs_[order[i]]);
+			normals[i].swap(faceNormals_[order[i]]);
+		}
+		faceUVs_.swap(uvs);
+		faceNormals_.swap(normals);
+	}
+	renumberVertices(vertices_, faces_);
+}
+
+//Write the vertices and faces to an OBJ file, so an optimized model can be saved once and loaded many times
+bool Model::write_obj_file(const char* filename) const{
+	std::ofstream out(filename);
+	if(!out.is_open()){
+		std::cerr << "Can't open file " << filename << " for writing\n";
+		return false;
+	}
+	out.precision(9);									//Enough digits for floats to read back unchanged
+
+	for(const Vec3f& v : vertices_)
+		out << "v " << v.x << " " << v.y << " " << v.z << "\n";
+	for(const Vec2f& t : uvs_)
+		out << "vt " << t.x_ << " " << t.y_ << "\n";
+	for(const Vec3f& n : normals_)
+		out << "vn " << n.x << " " << n.y << " " << n.z << "\n";
+	for(int i=0; i<int(faces_.size()); i++){
+		out << "f";
+		for(int j=0; j<int(faces_[i].size()); j++){
+			out << " " << faces_[i][j]+1;				//Wavefront obj indexing starts at 1
+			if(faceUVs_[i][j] >= 0) out << "/" << faceUVs_[i][j]+1 << "/" << faceNormals_[i][j]+1;
+			else out << "//" << faceNormals_[i][j]+1;
+		}
+		out << "\n";
+	}
+
+	if(!out.good()){
+		std::cerr << "An error occured while writing " << filename << "\n";
+		return false;
+	}
+	return true;
+}
+
+//Get every vertex at once, for passes that process the whole mesh
+const std::vector<Vec3f>& Model::verts() const{
+	return vertices_;
+}
+
+//Get the texture coordinate count
+int Model::nUVs() const{
+	return uvs_.size();
+}
+
+//Get a texture coordinate at index idx
+Vec2f Model::uv(int idx) const{
+	return uvs_[idx];
+}
+
+//Get a normal at index idx
+Vec3f Model::normal(int idx) const{
+	return normals_[idx];
+}
+
+//Get the vertex index of a face corner, without copying the face
+int Model::faceVert(int face, int corner) const{
+	return faces_[face][corner];
+}
+
+//Get the texture coordinate index of a face corner, -1 if it has none
+int Model::faceUV(int face, int corner) const{
+	return faceUVs_[face][corner];
+}
+
+//Get the normal index of a face corner, always valid
+int Model::faceNormal(int face, int corner) const{
+	return faceNormals_[face][corner];
+}
+
+//Get the minimum corner of the bounding box
+Vec3f Model::bboxMin() const{
+	return bboxMin_;
+}
+
+//Get the maximum corner of the bounding box
+Vec3f Model::bboxMax() const{
+	return bboxMax_;
+}
+
+void Model::debug(){
+	std::cerr << "#v: " << nVerts() << " #f " << nFaces() << "\n";
 }
\ No newline at end of file
@@ -0,0 +1,65 @@
+#include "my_gl.h"
+
+#include <cfloat>
+
+//Empty target
+RenderTarget::RenderTarget() : color(nullptr), depth(nullptr), colorPitch(0), depthPitch(0), bytesPerPixel(0), x0(0), y0(0), width(0), height(0) {}
+
+//Target covering a whole image, zbuffer is resized to fit the image and cleared to the far plane
+RenderTarget::RenderTarget(TGAImage& image, std::vector<float>& zbuffer) :
+			color(image.buffer()), depth(nullptr), colorPitch(image.get_width()*image.get_bytespp()), depthPitch(paddedPitch(image.get_width())),
+			bytesPerPixel(image.get_bytespp()), x0(0), y0(0), width(image.get_width()), height(image.get_height()) {
+	zbuffer.assign(depthPitch*height, FLT_MAX);
+	depth = zbuffer.data();
+}
+
+//Empty plane, always 0
+Plane::Plane() : origin(0), dx(0), dy(0), x0(0), y0(0) {}
+
+//Plane through the values a, b and c at the triangle's vertices pts
+//Degenerate triangles (never drawn) give a constant plane
+Plane::Plane(const Vec3f* pts, const float a, const float b, const float c) : origin(a), dx(0), dy(0), x0(0), y0(0) {
+	std::int64_t X[3], Y[3];
+	for(int i=0; i<3; i++){
+		X[i] = std::lrint(pts[i].x*SUBPIXEL);
+		Y[i] = std::lrint(pts[i].y*SUBPIXEL);
+	}
+	const float fx1 = float(X[1]-X[0])/SUBPIXEL, fy1 = float(Y[1]-Y[0])/SUBPIXEL;
+	const float fx2 = float(X[2]-X[0])/SUBPIXEL, fy2 = float(Y[2]-Y[0])/SUBPIXEL;
+	const float det = fx1*fy2 - fx2*fy1;
+	x0 = float(X[0])/SUBPIXEL;
+	y0 = float(Y[0])/SUBPIXEL;
+	if(det == 0) return;
+	dx = ((b-a)*fy2 - (c-a)*fy1)/det;
+	dy = ((c-a)*fx1 - (b-a)*fx2)/det;
+}
+
+//Row length of a depth buffer, rounded up so a block row can always be read as 4 floats
+int paddedPitch(const int width){
+	return (width+BLOCK-1) & ~(BLOCK-1);
+}
+
+//Fill a triangle with a flat pixel of the target's format
+template<TGAImage::Format F>
+static void flatTriangle(const Vec3f* pts, const Pixel<F> pixel, RenderTarget& target){
+	rasterizeTriangle(pts, target, [&](int, int, int mask, std::uint8_t* crow){
+		Pixel<F>* row = reinterpret_cast<Pixel<F>*>(crow);
+		for(int i=0; i<BLOCK; i++)
+			if(mask & (1 << i)) row[i] = pixel;
+	});
+}
+
+//Fill a triangle with a flat color, pts are screen coordinates and depth (see rasterizeTriangle)
+void triangle(const Vec3f* pts, const TGAColor& color, RenderTarget& target){
+	switch(target.bytesPerPixel){
+		case TGAImage::RGBA: flatTriangle<TGAImage::RGBA>(pts, color, target); break;
+		case TGAImage::RGB: flatTriangle<TGAImage::RGB>(pts, color, target); break;
+		default: flatTriangle<TGAImage::GRAYSCALE>(pts, color, target);
+	}
+}
+
+//Draw a triangle's depth only, for depth passes such as shadow maps (the target needs no color buffer)
+//The empty fill leaves the inner loop with just the edge and depth tests
+void depthTriangle(const Vec3f* pts, RenderTarget& target){
+	rasterizeTriangle(pts, target, [](int, int, int, std::uint8_t*){});
+}
\ No newline at end of file
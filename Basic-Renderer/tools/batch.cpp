@@ -0,0 +1,218 @@
+#include "TGAImage.h"
+#include "BoundedQueue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+//Batch image converter: every listed image (TGA, PPM/PGM or QOI, directories are searched for them) is decoded, given
+//the same transforms and saved in one format, many files at a time
+//Decoding and transforming + encoding are two pipeline stages joined by queues of image slots: a file is decoded into
+//a free slot, handed to an encoder and the slot comes back once its file is written. The slots bound how many images
+//are in memory at once and their buffers are reused from file to file, so a batch allocates its images once
+
+//Image slot of the pipeline
+struct Slot {
+	TGAImage image;
+	TGAImage scaled;						//Output of --scale, reused like image
+	int file;								//Index of the file in the slot
+};
+
+//Lowercase extension of a path, with the dot
+static std::string extension(const std::filesystem::path& path){
+	std::string ext = path.extension().string();
+	for(char& c : ext) c = std::tolower(c);
+	return ext;
+}
+
+//Whether the tool reads files with an extension
+static bool readable(const std::string& ext){
+	return ext == ".tga" || ext == ".ppm" || ext == ".pgm" || ext == ".qoi";
+}
+
+//Decode a file by its extension
+static bool decode(const std::filesystem::path& path, TGAImage& image){
+	const std::string ext = extension(path);
+	if(ext == ".qoi") return image.read_qoi_file(path.string());
+	if(ext == ".ppm" || ext == ".pgm") return image.read_ppm_file(path.string());
+	return image.read_tga_file(path.string());
+}
+
+//Encode an image in a format, the picture is saved as it is seen (no vflip)
+static bool encode(const TGAImage& image, const std::string& filename, const std::string& format, const bool rle){
+	if(format == "qoi") return image.write_qoi_file(filename, false);
+	if(format == "ppm") return image.write_ppm_file(filename, false);
+	return image.write_tga_file(filename, false, rle, 1);
+}
+
+int main(int argc, char** argv){
+
+	std::vector<std::filesystem::path> files;
+	std::string format = "tga";
+	std::string outDir;
+	bool rle = true;
+	int flips = 0;							//1 vertical, 2 horizontal
+	int scaleWidth = 0, scaleHeight = 0;
+	float scaleFactor = 0;
+	TGAImage::Filter filter = TGAImage::BILINEAR;
+	int threads = 0;
+	int inFlight = 0;
+
+	//Usage: batch [--to tga|qoi|ppm] [--raw] [--out dir] [--flip v|h|vh] [--scale WxH|factor] [--filter nearest|box|bilinear|lanczos3]
+	//             [--threads n] [--in-flight n] [--list file] file|directory..
+	for(int i=1; i<argc; i++){
+		if(!strcmp(argv[i], "--to") && i+1<argc){
+			format = argv[++i];								//Output format, the output takes the input's name with its extension
+		}else if(!strcmp(argv[i], "--raw")){
+			rle = false;									//Uncompressed TGA output
+		}else if(!strcmp(argv[i], "--out") && i+1<argc){
+			outDir = argv[++i];								//Directory for the outputs, next to each input by default
+		}else if(!strcmp(argv[i], "--flip") && i+1<argc){
+			const char* f = argv[++i];
+			flips = (strchr(f, 'v') ? 1 : 0) | (strchr(f, 'h') ? 2 : 0);
+		}else if(!strcmp(argv[i], "--scale") && i+1<argc){
+			if(sscanf(argv[++i], "%dx%d", &scaleWidth, &scaleHeight) != 2){
+				scaleWidth = scaleHeight = 0;
+				scaleFactor = atof(argv[i]);				//Or a factor of each image's size
+			}
+		}else if(!strcmp(argv[i], "--filter") && i+1<argc){
+			const char* f = argv[++i];
+			filter = !strcmp(f, "nearest") ? TGAImage::NEAREST : !strcmp(f, "box") ? TGAImage::BOX :
+						!strcmp(f, "lanczos3") ? TGAImage::LANCZOS3 : TGAImage::BILINEAR;
+		}else if(!strcmp(argv[i], "--threads") && i+1<argc){
+			threads = atoi(argv[++i]);						//Encoder threads, 0 (default) uses every core
+		}else if(!strcmp(argv[i], "--in-flight") && i+1<argc){
+			inFlight = atoi(argv[++i]);						//Images held at once, twice the threads by default
+		}else if(!strcmp(argv[i], "--list") && i+1<argc){
+			std::ifstream list(argv[++i]);					//One path per line
+			if(!list.is_open()) std::cerr << "Can't open list " << argv[i] << "\n";
+			for(std::string line; std::getline(list, line);)
+				if(!line.empty()) files.push_back(line);
+		}else if(std::filesystem::is_directory(argv[i])){
+			std::vector<std::filesystem::path> found;
+			for(const std::filesystem::directory_entry& e : std::filesystem::directory_iterator(argv[i]))
+				if(e.is_regular_file() && readable(extension(e.path()))) found.push_back(e.path());
+			std::sort(found.begin(), found.end());
+			files.insert(files.end(), found.begin(), found.end());
+		}else{
+			files.push_back(argv[i]);
+		}
+	}
+	if(format != "tga" && format != "qoi" && format != "ppm"){
+		std::cerr << "Unknown output format " << format << ", use tga, qoi or ppm\n";
+		return 1;
+	}
+	if(files.empty()){
+		std::cerr << "No images to convert\n";
+		return 1;
+	}
+	if(!outDir.empty()) std::filesystem::create_directories(outDir);
+
+	//Outputs take the inputs' names with the format's extension, they must not replace an input or each other
+	//(a.tga and a.ppm both give a.qoi), two encoders would write the same file at once
+	std::vector<std::filesystem::path> outputs;
+	std::vector<std::string> sortedInputs, sortedOutputs;		//Full paths, to compare the names
+	for(const std::filesystem::path& input : files){
+		std::filesystem::path output = outDir.empty() ? input : std::filesystem::path(outDir)/input.filename();
+		outputs.push_back(output.replace_extension("." + format));
+		sortedInputs.push_back(std::filesystem::weakly_canonical(std::filesystem::absolute(input)).string());
+		sortedOutputs.push_back(std::filesystem::weakly_canonical(std::filesystem::absolute(output)).string());
+	}
+	std::sort(sortedInputs.begin(), sortedInputs.end());
+	std::sort(sortedOutputs.begin(), sortedOutputs.end());
+	bool clash = false;
+	for(size_t i=0; i<sortedOutputs.size(); i++){
+		if(std::binary_search(sortedInputs.begin(), sortedInputs.end(), sortedOutputs[i])){
+			std::cerr << "Converting would overwrite the input " << sortedOutputs[i] << ", give another --out directory\n";
+			clash = true;
+		}else if(i > 0 && sortedOutputs[i] == sortedOutputs[i-1]){
+			std::cerr << "Several inputs would be converted to " << sortedOutputs[i] << "\n";
+			clash = true;
+		}
+	}
+	if(clash) return 1;
+
+	const int encoders = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+	const int decoders = std::max(1, encoders/2);
+	std::vector<Slot> slots(std::max(inFlight > 0 ? inFlight : 2*encoders, 1));
+	BoundedQueue<int> freeSlots(slots.size()), decoded(slots.size());
+	for(int i=0; i<int(slots.size()); i++) freeSlots.push(i);
+
+	std::atomic<int> next(0), failures(0);
+	std::atomic<long long> bytesRead(0), bytesWritten(0), pixelBytes(0);
+	const auto start = std::chrono::steady_clock::now();
+
+	//Stage 1: take the next file and decode it into a free slot
+	auto decodeLoop = [&](){
+		int s;
+		while(freeSlots.pop(s)){
+			const int file = next++;
+			if(file >= int(files.size())){
+				freeSlots.push(s);
+				return;
+			}
+			if(!decode(files[file], slots[s].image)){
+				std::cerr << "Can't read " << files[file].string() << "\n";
+				failures++;
+				freeSlots.push(s);
+				continue;
+			}
+			std::error_code error;
+			bytesRead += std::filesystem::file_size(files[file], error);
+			slots[s].file = file;
+			decoded.push(s);
+		}
+	};
+
+	//Stage 2: transform a decoded image, encode it and give its slot back
+	auto encodeLoop = [&](){
+		int s;
+		while(decoded.pop(s)){
+			Slot& slot = slots[s];
+			TGAImage* out = &slot.image;
+			if(flips & 1) out->flip_vertically();
+			if(flips & 2) out->flip_horizontally();
+			const int w = scaleFactor > 0 ? std::max(1, int(out->get_width()*scaleFactor+0.5f)) : scaleWidth;
+			const int h = scaleFactor > 0 ? std::max(1, int(out->get_height()*scaleFactor+0.5f)) : scaleHeight;
+			if(w > 0 && h > 0){
+				out->scale(slot.scaled, w, h, filter, 1);
+				out = &slot.scaled;
+			}
+
+			const std::filesystem::path& output = outputs[slot.file];
+			std::error_code error;
+			if(encode(*out, output.string(), format, rle)){
+				pixelBytes += (long long)(slot.image.get_width())*slot.image.get_height()*slot.image.get_bytespp();
+				bytesWritten += std::filesystem::file_size(output, error);
+			}else{
+				std::cerr << "Can't write " << output.string() << "\n";
+				failures++;
+			}
+			freeSlots.push(s);
+		}
+	};
+
+	std::vector<std::thread> decoding, encoding;
+	for(int i=0; i<decoders; i++) decoding.emplace_back(decodeLoop);
+	for(int i=0; i<encoders; i++) encoding.emplace_back(encodeLoop);
+	for(std::thread& t : decoding) t.join();
+	decoded.close();
+	for(std::thread& t : encoding) t.join();
+
+	const double seconds = std::max(1e-9, std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count());
+	const int done = int(files.size())-failures;
+	const double MB = 1 << 20;
+	printf("%d files (%d failed) in %.3f s: %.1f files/s, %.1f MB/s of pixels, %.1f MB/s read, %.1f MB/s written\n",
+			done, int(failures), seconds, done/seconds, pixelBytes/MB/seconds, bytesRead/MB/seconds, bytesWritten/MB/seconds);
+	return failures ? 1 : 0;
+}
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include "Bench.h"
+#include "Model.h"
+#include "Bresenham.h"
+#include "Rasterize.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//Renderer benchmarks: line drawing, OBJ parsing, TGA RLE encoding and decoding, flips and scaling (micro), and whole
+//wireframe and filled renders of the bundled models (macro). Run from Basic-Renderer or give the models' directory
+//Usage: bench [--obj dir] [--size n] plus the options in Bench.h, e.g. bench --json base.json then bench --baseline base.json
+//Threaded paths run on one thread so timings don't depend on the machine's cores
+
+//Size x size test picture like the renderer's outputs: a gradient, flat areas and lines
+static TGAImage testImage(const int size){
+	TGAImage image(size, size, TGAImage::RGB);
+	for(int y=0; y<size; y++)
+		for(int x=0; x<size/2; x++) image.set(x, y, TGAColor(x*255/size, y*255/size, 96));
+	std::mt19937 random(1);
+	for(int i=0; i<2000; i++){
+		const TGAColor color(random() & 255, random() & 255, random() & 255);
+		line(random()%size, random()%size, random()%size, random()%size, image, color);
+	}
+	return image;
+}
+
+int main(int argc, char** argv){
+
+	Bench bench(argc, argv);
+	std::string objDir = "obj";
+	int size = 1000;							//Width and height of the images drawn and encoded
+	for(int i=1; i<argc; i++){
+		if(!strcmp(argv[i], "--obj") && i+1<argc) objDir = argv[++i];
+		else if(!strcmp(argv[i], "--size") && i+1<argc) size = std::max(16, atoi(argv[++i]));
+	}
+	const TGAColor white(255, 255, 255);
+
+	//Lines: the same 4096 random lines are drawn in turn, short ones within 16 pixels and long ones across the image
+	{
+		std::mt19937 random(2);
+		std::vector<int> shortLines, longLines;
+		for(int i=0; i<4096; i++){
+			const int x = random()%size, y = random()%size;
+			shortLines.insert(shortLines.end(), {x, y, x+int(random()%33)-16, y+int(random()%33)-16});
+			longLines.insert(longLines.end(), {int(random()%size), int(random()%size), int(random()%size), int(random()%size)});
+		}
+		TGAImage image(size, size, TGAImage::RGB);
+		size_t nextShort = 0, nextLong = 0, nextClipped = 0;
+		bench.run("line.short", [&](){
+			const int* l = &shortLines[nextShort];
+			line(l[0], l[1], l[2], l[3], image, white);
+			nextShort = (nextShort+4)%shortLines.size();
+		});
+		bench.run("line.long", [&](){
+			const int* l = &longLines[nextLong];
+			line(l[0], l[1], l[2], l[3], image, white);
+			nextLong = (nextLong+4)%longLines.size();
+		});
+		bench.run("line.clipped", [&](){
+			const int* l = &longLines[nextClipped];
+			line(l[0]*3-size, l[1]*3-size, l[2]*3-size, l[3]*3-size, image, white);
+			nextClipped = (nextClipped+4)%longLines.size();
+		});
+	}
+
+	//OBJ parsing and whole renders of each bundled model
+	for(const char* name : {"african_head", "CoronaCap"}){
+		const std::string file = objDir + "/" + name + ".obj";
+		std::error_code error;
+		const double bytes = std::filesystem::file_size(file, error);
+		if(error){
+			std::cerr << "Can't find " << file << ", skipping its benchmarks (see --obj)\n";
+			continue;
+		}
+		bench.run(std::string("model.parse.") + name, [&](){
+			Model model(file.c_str());
+			keep(model);
+		}, bytes);
+
+		const std::string wireframe = std::string("render.wireframe.") + name, fill = std::string("render.fill.") + name;
+		if(!bench.selected(wireframe) && !bench.selected(fill)) continue;
+		const Model model(file.c_str());
+		const Viewport view = Viewport::fit(model.bboxMin(), model.bboxMax(), size, size);
+		TGAImage image(size, size, TGAImage::RGB);
+		bench.run(wireframe, [&](){
+			image.clear();
+			drawSegments(wireframeSegments(&model, view), image, white, 1);
+		});
+		bench.run(fill, [&](){
+			image.clear();
+			Rasterize(&model, FlatShader(&model, Vec3f(0, 0, 1)), view.clip(size, size), image, 1);
+		});
+	}
+
+	//Image operations on the test picture, throughput counts the picture's pixel bytes
+	const TGAImage picture = testImage(size);
+	const double pixelBytes = double(size)*size*picture.get_bytespp();
+	{
+		//Encoded to and decoded from memory, so the timings are the codec's and not the disk's
+		std::ostringstream encoded(std::ios::binary);
+		bench.run("tga.rle.encode", [&](){
+			encoded.str(std::string());
+			encoded.clear();
+			picture.write_tga(encoded, true, true, 1);
+		}, pixelBytes);
+		encoded.str(std::string());
+		encoded.clear();
+		picture.write_tga(encoded, true, true, 1);
+		std::istringstream in(encoded.str(), std::ios::binary);
+		TGAImage decoded;
+		bench.run("tga.rle.decode", [&](){
+			in.clear();
+			in.seekg(0);
+			decoded.read_tga(in);
+		}, pixelBytes);
+
+		TGAImage image = picture;
+		bench.run("flip.vertically", [&](){
+			image.flip_vertically();
+		}, pixelBytes);
+		bench.run("flip.horizontally", [&](){
+			image.flip_horizontally();
+		}, pixelBytes);
+
+		TGAImage scaled;
+		bench.run("scale.half.bilinear", [&](){
+			picture.scale(scaled, size/2, size/2, TGAImage::BILINEAR, 1);
+		}, pixelBytes);
+		bench.run("scale.half.lanczos3", [&](){
+			picture.scale(scaled, size/2, size/2, TGAImage::LANCZOS3, 1);
+		}, pixelBytes);
+		bench.run("scale.double.bilinear", [&](){
+			picture.scale(scaled, size*2, size*2, TGAImage::BILINEAR, 1);
+		}, pixelBytes);
+	}
+
+	return bench.finish();
+}
\ No newline at end of file
@@ -0,0 +1,195 @@
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//Small benchmark harness shared by the bench tools of Basic-Renderer and Basic-Raytracing (make bench in either)
+//An operation is timed in samples: each sample repeats it long enough to be measured (sampleTime seconds), the median
+//sample gives ns/op and their standard deviation the spread. Results can be saved as JSON and compared to a saved
+//baseline, operations slower than the baseline by more than a threshold count as regressions
+//Options read from the command line: --filter text (run the benchmarks whose name contains text) --samples n
+//--time seconds (per sample) --json file (save the results) --baseline file --threshold percent (default 10)
+
+//Timing of one benchmark
+struct BenchResult {
+	std::string name;
+	double nsPerOp;						//Median of the samples
+	double minNs;						//Fastest sample
+	double spread;						//Standard deviation of the samples, percent of their mean
+	double bytesPerOp;					//Throughput is in MB/s if set, operations/s otherwise
+	long long ops;						//Operations timed in all
+};
+
+//Keep the compiler from removing the computation of a value that is never used
+template<typename T>
+inline void keep(const T& value){
+#if defined(__GNUC__)
+	asm volatile("" : : "g"(&value) : "memory");
+#else
+	static volatile const void* sink;
+	sink = &value;
+#endif
+}
+
+class Bench {
+private:
+	std::vector<BenchResult> results_;
+	std::string filter_;
+	int samples_;
+	double sampleTime_;					//Seconds a sample should last
+	std::string json_, baseline_;
+	double threshold_;					//Percent
+
+	void report(const BenchResult&) const;
+	bool save(const std::string&) const;
+	int compare(const std::string&) const;
+
+public:
+	Bench(const int, char**);
+
+	bool selected(const std::string&) const;
+	template<typename F> void run(const std::string&, F, const double =0);
+	int finish() const;
+};
+
+//Read the harness options, arguments it doesn't know are left to the benchmark
+inline Bench::Bench(const int argc, char** argv) : results_(), filter_(), samples_(10), sampleTime_(0.05), json_(), baseline_(),
+		threshold_(10) {
+	for(int i=1; i<argc; i++){
+		if(!strcmp(argv[i], "--filter") && i+1<argc) filter_ = argv[++i];
+		else if(!strcmp(argv[i], "--samples") && i+1<argc) samples_ = std::max(2, atoi(argv[++i]));
+		else if(!strcmp(argv[i], "--time") && i+1<argc) sampleTime_ = std::max(1e-4, atof(argv[++i]));
+		else if(!strcmp(argv[i], "--json") && i+1<argc) json_ = argv[++i];
+		else if(!strcmp(argv[i], "--baseline") && i+1<argc) baseline_ = argv[++i];
+		else if(!strcmp(argv[i], "--threshold") && i+1<argc) threshold_ = atof(argv[++i]);
+	}
+	printf("%-32s %14s %14s %8s %16s\n", "benchmark", "ns/op", "min ns/op", "spread", "throughput");
+}
+
+//Whether a benchmark passes the filter, to skip its setup as well
+inline bool Bench::selected(const std::string& name) const{
+	return filter_.empty() || name.find(filter_) != std::string::npos;
+}
+
+//Time op(), which does one operation of bytesPerOp bytes (0 to count operations instead)
+//The first call warms up and sets how many calls a sample makes
+template<typename F>
+void Bench::run(const std::string& name, F op, const double bytesPerOp){
+	if(!selected(name)) return;
+	typedef std::chrono::steady_clock Clock;
+
+	Clock::time_point start = Clock::now();
+	op();
+	const double once = std::max(1e-9, std::chrono::duration<double>(Clock::now()-start).count());
+	const long long repeat = std::max(1LL, (long long)(sampleTime_/once));
+
+	std::vector<double> ns(samples_);
+	for(double& sample : ns){
+		start = Clock::now();
+		for(long long i=0; i<repeat; i++) op();
+		sample = std::chrono::duration<double, std::nano>(Clock::now()-start).count()/repeat;
+	}
+
+	double mean = 0, variance = 0;
+	for(const double sample : ns) mean += sample;
+	mean /= samples_;
+	for(const double sample : ns) variance += (sample-mean)*(sample-mean);
+	variance /= samples_-1;
+
+	std::sort(ns.begin(), ns.end());
+	const double median = samples_ & 1 ? ns[samples_/2] : (ns[samples_/2-1]+ns[samples_/2])/2;
+	results_.push_back(BenchResult{name, median, ns[0], mean > 0 ? 100*std::sqrt(variance)/mean : 0, bytesPerOp, repeat*samples_});
+	report(results_.back());
+}
+
+//Print one result
+inline void Bench::report(const BenchResult& r) const{
+	char throughput[32];
+	if(r.bytesPerOp > 0) snprintf(throughput, sizeof(throughput), "%.1f MB/s", r.bytesPerOp/r.nsPerOp*1e9/(1 << 20));
+	else snprintf(throughput, sizeof(throughput), "%.0f op/s", 1e9/r.nsPerOp);
+	printf("%-32s %14.1f %14.1f %7.1f%% %16s\n", r.name.c_str(), r.nsPerOp, r.minNs, r.spread, throughput);
+	fflush(stdout);
+}
+
+//Save the results as JSON
+inline bool Bench::save(const std::string& filename) const{
+	std::ofstream out(filename);
+	if(!out.is_open()){
+		std::cerr << "Can't open " << filename << " for writing\n";
+		return false;
+	}
+	out << std::setprecision(10) << "{\n\t\"benchmarks\": [\n";
+	for(size_t i=0; i<results_.size(); i++){
+		const BenchResult& r = results_[i];
+		out << "\t\t{\"name\": \"" << r.name << "\", \"ns_per_op\": " << r.nsPerOp << ", \"min_ns\": " << r.minNs
+			<< ", \"spread_pct\": " << r.spread << ", \"bytes_per_op\": " << r.bytesPerOp << ", \"ops\": " << r.ops << "}"
+			<< (i+1 < results_.size() ? ",\n" : "\n");
+	}
+	out << "\t]\n}\n";
+	return out.good();
+}
+
+//Compare the results to a file saved by save(), only names and ns_per_op are read from it
+//Returns the number of regressions, -1 if the file can't be read
+inline int Bench::compare(const std::string& filename) const{
+	std::ifstream in(filename);
+	if(!in.is_open()){
+		std::cerr << "Can't open baseline " << filename << "\n";
+		return -1;
+	}
+	std::stringstream text;
+	text << in.rdbuf();
+	const std::string json = text.str();
+
+	std::vector<std::pair<std::string, double>> baseline;
+	for(size_t at = json.find("\"name\""); at != std::string::npos; at = json.find("\"name\"", at)){
+		const size_t open = json.find('"', json.find(':', at));
+		const size_t close = json.find('"', open+1);
+		const size_t key = json.find("\"ns_per_op\"", close);
+		if(open == std::string::npos || close == std::string::npos || key == std::string::npos) break;
+		baseline.emplace_back(json.substr(open+1, close-open-1), atof(json.c_str() + json.find(':', key)+1));
+		at = key;
+	}
+	if(baseline.empty()){
+		std::cerr << "No benchmarks in baseline " << filename << "\n";
+		return -1;
+	}
+
+	printf("\n%-32s %14s %14s %8s\n", "compared to baseline", "baseline ns", "ns/op", "change");
+	int regressions = 0;
+	for(const BenchResult& r : results_){
+		const auto found = std::find_if(baseline.begin(), baseline.end(),
+										[&r](const std::pair<std::string, double>& b){ return b.first == r.name; });
+		if(found == baseline.end() || found->second <= 0){
+			printf("%-32s %14s %14.1f %8s\n", r.name.c_str(), "-", r.nsPerOp, "new");
+			continue;
+		}
+		const double change = 100*(r.nsPerOp/found->second - 1);
+		const char* verdict = change > threshold_ ? "  REGRESSION" : change < -threshold_ ? "  faster" : "";
+		if(change > threshold_) regressions++;
+		printf("%-32s %14.1f %14.1f %+7.1f%%%s\n", r.name.c_str(), found->second, r.nsPerOp, change, verdict);
+	}
+	printf("%d regression%s past %.1f%%\n", regressions, regressions == 1 ? "" : "s", threshold_);
+	return regressions;
+}
+
+//Save and compare the results as asked, returns the exit code: 1 on a regression or an error
+inline int Bench::finish() const{
+	bool ok = true;
+	if(!json_.empty()) ok = save(json_) && ok;
+	if(!baseline_.empty()) ok = compare(baseline_) == 0 && ok;
+	return ok ? 0 : 1;
+}
+
+#endif //__BENCH_H__
\ No newline at end of file